@@ -39,6 +39,11 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <setjmp.h>
+#include <stdarg.h>
+
+#include "myunit_vclock.h"
+#include "myunit_cover.h"
 
 
 #define MYUNIT_SILENT                   0   /*!< \brief No output, silent mode */
@@ -62,9 +67,16 @@
    #define MYUNIT_VERBOSE  MYUNIT_VERB3_ALL_ASSERTS
 #endif
 
+/*!
+    \brief Builds a test suite which lists its test cases instead of executing them.
+    \details The inventory of the test cases is printed at startup, see `myunit_inventory_print`.
+*/
 #ifdef MYUNIT_LIST_UNITTESTS
     #undef MYUNIT_VERBOSE
     #define MYUNIT_VERBOSE  MYUNIT_SILENT
+    #ifndef MYUNIT_INVENTORY
+    #define MYUNIT_INVENTORY
+    #endif
 #endif
 
 
@@ -113,6 +125,27 @@ int myunit_testcase_assert_success_count;    /*!< Successful assertions in the c
 int myunit_testcase_assert_fail_count;       /*!< Failed assertions in the current test case. Reset after each test case.*/
 int myunit_testcase_success_count;           /*!< Successfully completed test cases in the test suite. */
 int myunit_testcase_fail_count;              /*!< Failed test cases in the test suite. */
+int myunit_testcase_last_line;               /*!< Line of the last passed assertion in the current test case. Reset after each test case. */
+int myunit_testcase_skip_count;              /*!< Test cases skipped after the test suite was stopped by fail-fast. */
+/*!
+    \def MYUNIT_SETJMP
+    \brief Saves the context of the running test case, `sigsetjmp` with the signal mask on POSIX platforms.
+    \details A test case aborted from the signal handler of the watchdog or of a fault returns through
+             `MYUNIT_LONGJMP`, which restores the signal mask, so the signal is unblocked for the next test case.
+*/
+#if defined(__unix__) || defined(__APPLE__)
+    #define MYUNIT_JMP_BUF              sigjmp_buf
+    #define MYUNIT_SETJMP(env)          sigsetjmp(env,1)
+    #define MYUNIT_LONGJMP(env,value)   siglongjmp(env,value)
+#else
+    #define MYUNIT_JMP_BUF              jmp_buf
+    #define MYUNIT_SETJMP(env)          setjmp(env)
+    #define MYUNIT_LONGJMP(env,value)   longjmp(env,value)
+#endif
+
+MYUNIT_JMP_BUF myunit_testcase_jmp_buf;      /*!< Context of the running test case, used to abort it from a watchdog. */
+bool myunit_testcase_running;                /*!< A test case is executing and may be aborted through `myunit_testcase_jmp_buf`. */
+bool myunit_testsuite_stopped;               /*!< Fail-fast limit reached, remaining test cases are skipped. */
 
 void (*myunit_action)(void) = NULL;
 
@@ -127,6 +160,292 @@ void (*myunit_action)(void) = NULL;
 #define MYUNIT_SET_ACTION(action) do{myunit_action=action;}while(0)
 
 
+#if defined(MYUNIT_FUZZ_LIBFUZZER) || defined(MYUNIT_FUZZ_AFL)
+    #define MYUNIT_ABORT_ON_FAILURE /*!< Fuzz builds report failed assertions to the fuzzer by aborting */
+#endif
+
+/*!
+    \brief Runs the failure handling of a failed assertion.
+    \details Calls the action set by `MYUNIT_SET_ACTION`. If `MYUNIT_ABORT_ON_FAILURE` is defined, which is
+             the case in fuzz builds, the process is aborted afterwards so the fuzzer records a crash.
+             Otherwise the fail-fast limits are checked, see `MYUNIT_SET_FAIL_FAST`.
+*/
+#ifdef MYUNIT_ABORT_ON_FAILURE
+    #define MYUNIT_FAILURE_ACTION() do{if(myunit_action) myunit_action(); abort();}while(0)
+#else
+    #define MYUNIT_FAILURE_ACTION() do{if(myunit_action) myunit_action(); myunit_testsuite_fail_fast();}while(0)
+#endif
+
+void myunit_testsuite_fail_fast(void);
+
+
+#ifndef MYUNIT_MAX_FAILED_TESTCASES
+#define MYUNIT_MAX_FAILED_TESTCASES 0 /*!< Failed test cases after which the test suite is stopped, 0 runs all test cases. */
+#endif
+
+#ifndef MYUNIT_MAX_FAILED_ASSERTS
+#define MYUNIT_MAX_FAILED_ASSERTS 0 /*!< Failed assertions after which the test suite is stopped, 0 runs all test cases. */
+#endif
+
+uint32_t myunit_testsuite_max_failed_testcases = MYUNIT_MAX_FAILED_TESTCASES; /*!< Fail-fast limit of failed test cases. */
+uint32_t myunit_testsuite_max_failed_asserts = MYUNIT_MAX_FAILED_ASSERTS;     /*!< Fail-fast limit of failed assertions. */
+int myunit_testsuite_fail_fast_testcases;   /*!< Failed test cases when the fail-fast limits were set. */
+int myunit_testsuite_fail_fast_asserts;     /*!< Failed assertions when the fail-fast limits were set. */
+
+/*!
+    \brief Sets the fail-fast limits of the test suite.
+    \details Once `testcases` test cases or `asserts` assertions of the test suite have failed, the running
+             test case is aborted and all remaining test cases are skipped. Only failures after the limits are
+             set count. `MYUNIT_SET_FAIL_FAST(1,0)` stops the test suite after the next failed test case.
+
+    \param[in] testcases Failed test cases after which the test suite is stopped, 0 disables the limit.
+    \param[in] asserts Failed assertions after which the test suite is stopped, 0 disables the limit.
+*/
+#define MYUNIT_SET_FAIL_FAST(testcases,asserts) \
+    do{myunit_testsuite_max_failed_testcases=(testcases);myunit_testsuite_max_failed_asserts=(asserts);  \
+       myunit_testsuite_fail_fast_testcases=myunit_testcase_fail_count;                                   \
+       myunit_testsuite_fail_fast_asserts=myunit_testsuite_assert_fail_count;}while(0)
+
+
+#ifndef MYUNIT_REPEAT_COUNT
+#define MYUNIT_REPEAT_COUNT 1 /*!< Default number of executions of each test case. */
+#endif
+
+#ifndef MYUNIT_REPEAT_DURATION
+#define MYUNIT_REPEAT_DURATION 0 /*!< Default time in milliseconds each test case is repeated for, 0 disables. */
+#endif
+
+#ifndef MYUNIT_REPEAT_STOP
+#define MYUNIT_REPEAT_STOP false /*!< Default for stopping the repetitions of a test case at its first failure. */
+#endif
+
+#ifndef MYUNIT_REPEAT_SAMPLES
+#define MYUNIT_REPEAT_SAMPLES 32 /*!< Durations kept per repeated test case to estimate the median. */
+#endif
+
+uint32_t myunit_testsuite_repeat_count = MYUNIT_REPEAT_COUNT;       /*!< Executions of each test case, see MYUNIT_SET_REPEAT */
+uint32_t myunit_testsuite_repeat_duration = MYUNIT_REPEAT_DURATION; /*!< Repetition time of each test case in milliseconds, see MYUNIT_SET_REPEAT */
+bool myunit_testsuite_repeat_stop = MYUNIT_REPEAT_STOP;             /*!< Stop repeating a test case at its first failure, see MYUNIT_SET_REPEAT */
+uint32_t myunit_testsuite_seed = 0;                                 /*!< Base seed of the test cases, see MYUNIT_SET_SEED */
+uint32_t myunit_testcase_seed;                                      /*!< Seed of the running test case, see MYUNIT_SEED */
+
+/*!
+    \brief Repeats every subsequently executed test case.
+    \details Each test case is executed `count` times. If `duration` is set, it is executed at least `count` times
+             and until `duration` milliseconds have elapsed. A `<TCR>` record reports the number of executions and
+             failures, the minimum, median and maximum duration and a flakiness verdict per test case.
+
+    \param[in] count Executions of each test case, 1 disables repetitions.
+    \param[in] duration Time in milliseconds each test case is repeated for, 0 disables.
+    \param[in] stop Stop repeating a test case at its first failure.
+*/
+#define MYUNIT_SET_REPEAT(count,duration,stop) \
+    do{myunit_testsuite_repeat_count=(count);myunit_testsuite_repeat_duration=(duration);myunit_testsuite_repeat_stop=(stop);}while(0)
+
+/*!
+    \brief Sets the base seed of the test cases.
+    \details Without repetitions every test case runs with this seed, so the seed reported for a failed
+              repetition reproduces it in a single run.
+    \param[in] seed The new base seed.
+*/
+#define MYUNIT_SET_SEED(seed) do{myunit_testsuite_seed=(seed);}while(0)
+
+#ifdef MYUNIT_BASELINE
+
+#ifndef MYUNIT_BASELINE_BUFFER
+#define MYUNIT_BASELINE_BUFFER 8192 /*!< Bytes of the latest records of the baseline file which are kept. */
+#endif
+
+#ifndef MYUNIT_REGRESSION_Z
+#define MYUNIT_REGRESSION_Z 2.33 /*!< Default significance threshold of the Mann-Whitney z score, 2.33 is p < 0.01 one-sided. */
+#endif
+
+#ifndef MYUNIT_REGRESSION_TOLERANCE
+#define MYUNIT_REGRESSION_TOLERANCE 5 /*!< Default change of the median duration in percent below which no regression is reported. */
+#endif
+
+const char *myunit_baseline_path;                                       /*!< Baseline compared to, `MYUNIT_BASELINE` option */
+const char *myunit_baseline_save_path;                                  /*!< Baseline written, `MYUNIT_BASELINE_SAVE` option */
+double myunit_regression_z = MYUNIT_REGRESSION_Z;                       /*!< Significance threshold, see MYUNIT_SET_REGRESSION_THRESHOLD */
+uint32_t myunit_regression_tolerance = MYUNIT_REGRESSION_TOLERANCE;     /*!< Tolerated change in percent, see MYUNIT_SET_REGRESSION_THRESHOLD */
+
+/*!
+    \brief Sets the thresholds of the regression check against the baseline.
+    \details A repeated test case regressed if its durations are significantly longer than in the baseline, i.e.
+             the Mann-Whitney z score reaches `z`, and its median duration grew by more than `tolerance` percent.
+    \param[in] z Significance threshold of the z score.
+    \param[in] tolerance Tolerated growth of the median duration in percent.
+*/
+#define MYUNIT_SET_REGRESSION_THRESHOLD(z,tolerance) \
+    do{myunit_regression_z=(z);myunit_regression_tolerance=(tolerance);}while(0)
+
+#endif
+
+/*!
+    \brief Returns the seed of the running test case.
+    \details Test cases that randomize their inputs should derive them from this seed. Each repetition of a
+             repeated test case gets a different seed.
+*/
+#define MYUNIT_SEED() (myunit_testcase_seed)
+
+/*!
+    \brief Derives a well mixed 32-bit value from `x` (splitmix32).
+*/
+uint32_t myunit_seed_mix(uint32_t x)
+{
+    x += 0x9E3779B9UL;
+    x = (x ^ (x >> 16)) * 0x85EBCA6BUL;
+    x = (x ^ (x >> 13)) * 0xC2B2AE35UL;
+    return x ^ (x >> 16);
+}
+
+
+/*!
+    \brief Writes the decimal digits of `value` to `text`, without a terminator.
+    \return The end of the digits.
+*/
+char *myunit_format_unsigned(char *text, uint32_t value)
+{
+    char digits[10];
+    int count = 0;
+
+    do { digits[count++] = (char)('0' + value % 10); value /= 10; } while (value);
+    while (count) *text++ = digits[--count];
+    return text;
+}
+
+
+#ifndef MYUNIT_TESTCASE_NAME_SIZE
+#define MYUNIT_TESTCASE_NAME_SIZE 64 /*!< Size of the buffer holding the name of a parameterized test case row, including the index. */
+#endif
+
+#ifndef MYUNIT_TESTCASE_TIMEOUT
+#define MYUNIT_TESTCASE_TIMEOUT 0 /*!< Default test case timeout in milliseconds, 0 disables the watchdog. */
+#endif
+
+uint32_t myunit_testsuite_timeout = MYUNIT_TESTCASE_TIMEOUT; /*!< Timeout in milliseconds applied to test cases without an explicit timeout. */
+
+/*!
+    \brief Sets the default timeout for the test cases of the test suite.
+
+    \param[in] timeout Timeout in milliseconds for every subsequently executed test case, 0 disables the watchdog.
+*/
+#define MYUNIT_SET_TIMEOUT(timeout) do{myunit_testsuite_timeout=(timeout);}while(0)
+
+const char *myunit_testsuite_filter = NULL; /*!< Name of the only test case to execute, NULL executes all test cases. */
+
+
+void (*myunit_testcase_setup)(void) = NULL;    /*!< Fixture setup executed before every test case. */
+void (*myunit_testcase_teardown)(void) = NULL; /*!< Fixture teardown executed after every test case. */
+
+/*!
+    \brief Sets the fixture of the subsequently executed test cases.
+    \details `setup` runs before and `teardown` after every test case, also after a failed or aborted one.
+             `setup` runs as part of the test case, so a failed `MYUNIT_REQUIRE` in it aborts the test case.
+
+    \param[in] setup Function executed before every test case, NULL for none.
+    \param[in] teardown Function executed after every test case, NULL for none.
+*/
+#define MYUNIT_SET_FIXTURE(setup,teardown) do{myunit_testcase_setup=(setup);myunit_testcase_teardown=(teardown);}while(0)
+
+
+#ifndef MYUNIT_ISOLATION
+#define MYUNIT_ISOLATION false /*!< Default for running every test case in an isolated copy of the test process. */
+#endif
+
+bool myunit_testsuite_isolation = MYUNIT_ISOLATION; /*!< Run test cases isolated, see MYUNIT_SET_ISOLATION */
+
+/*!
+    \brief Runs the subsequently executed test cases in an isolated copy of the test process.
+    \details See `myunit_platform_isolated`. Changes of a test case to memory are discarded, so every test
+             case starts from the state the test suite has built. A crash only fails the test case. Platforms
+             without isolation run the test cases in place.
+
+    \param[in] enable `true` to isolate the test cases.
+*/
+#define MYUNIT_SET_ISOLATION(enable) do{myunit_testsuite_isolation=(enable);}while(0)
+
+
+#ifndef MYUNIT_SNAPSHOT_REGIONS
+#define MYUNIT_SNAPSHOT_REGIONS 4 /*!< Memory regions which can be registered for the snapshot. */
+#endif
+
+/*!
+    \brief Memory region restored before every test case.
+*/
+typedef struct {
+    void *region;                           /*!< Memory restored before every test case */
+    void *backup;                           /*!< Copy of the region taken by myunit_snapshot_take */
+    size_t size;                            /*!< Size of the region and its backup */
+} myunit_snapshot_region_t;
+
+myunit_snapshot_region_t myunit_snapshot_regions[MYUNIT_SNAPSHOT_REGIONS]; /*!< Registered regions. */
+size_t myunit_snapshot_count;               /*!< Number of registered regions. */
+bool myunit_snapshot_taken;                 /*!< The regions are restored before every test case. */
+
+/*!
+    \brief Registers a memory region for the snapshot.
+    \param region The memory to restore.
+    \param backup Memory of `size` bytes holding the snapshot, provided by the caller, so nothing is allocated.
+    \param size Size of the region.
+    \return `false` if `MYUNIT_SNAPSHOT_REGIONS` regions are already registered.
+*/
+bool myunit_snapshot_region(void *region, void *backup, size_t size)
+{
+    if (myunit_snapshot_count >= MYUNIT_SNAPSHOT_REGIONS) return false;
+
+    myunit_snapshot_regions[myunit_snapshot_count].region = region;
+    myunit_snapshot_regions[myunit_snapshot_count].backup = backup;
+    myunit_snapshot_regions[myunit_snapshot_count].size = size;
+    myunit_snapshot_count++;
+    return true;
+}
+
+/*!
+    \brief Copies the registered regions to their backups and restores them before every subsequent test case.
+*/
+void myunit_snapshot_take(void)
+{
+    size_t idx;
+
+    for (idx = 0; idx < myunit_snapshot_count; idx++)
+    {
+        memcpy(myunit_snapshot_regions[idx].backup,myunit_snapshot_regions[idx].region,myunit_snapshot_regions[idx].size);
+    }
+    myunit_snapshot_taken = true;
+}
+
+/*!
+    \brief Restores the registered regions from the snapshot, if one was taken.
+*/
+void myunit_snapshot_restore(void)
+{
+    size_t idx;
+
+    if (!myunit_snapshot_taken) return;
+
+    for (idx = 0; idx < myunit_snapshot_count; idx++)
+    {
+        memcpy(myunit_snapshot_regions[idx].region,myunit_snapshot_regions[idx].backup,myunit_snapshot_regions[idx].size);
+    }
+}
+
+/*!
+    \brief Registers a memory region for the snapshot, see `myunit_snapshot_region`.
+*/
+#define MYUNIT_SNAPSHOT_REGION(region,backup,size) myunit_snapshot_region(region,backup,size)
+
+/*!
+    \brief Takes the snapshot of the registered regions, after the test suite has built their state.
+*/
+#define MYUNIT_SNAPSHOT_TAKE() myunit_snapshot_take()
+
+/*!
+    \brief Stops restoring the snapshot and unregisters all regions.
+*/
+#define MYUNIT_SNAPSHOT_DROP() do{myunit_snapshot_count=0;myunit_snapshot_taken=false;}while(0)
+
+
 /*!
     \brief Initializes the platform for the unit testing framework.
 
@@ -155,9 +474,25 @@ extern void myunit_platform_deinit(void);
     \param[in] ...    Additional arguments matching the format string.
 
     \return The number of characters printed on success, or a negative value on error.
+    \note Only used if `MYUNIT_PLATFORM_PRINTF` is defined, by default the output goes through
+          `myunit_platform_write`.
 */
 extern int myunit_platform_printf(const char *format, ...);
 
+/*!
+    \brief Writes text to the platform's logging interface.
+
+    \details The built-in formatter `myunit_printf` passes the formatted text to
+             this function in chunks of up to `MYUNIT_FORMAT_BUFFER` characters.
+             The text is not terminated.
+
+    \param[in] buffer The text to write.
+    \param[in] len    The number of characters to write.
+
+    \return The number of characters written on success, or a negative value on error.
+*/
+extern int myunit_platform_write(const char *buffer, size_t len);
+
 /*!
     \brief Puts the platform into a safe state.
 
@@ -196,287 +531,2652 @@ extern void myunit_platform_reset(void);
 */
 extern void myunit_platform_exception(void);
 
+/*!
+    \brief Arms the test case watchdog.
 
+    \details This function starts a one-shot timer which calls `expired` once `timeout`
+             milliseconds have elapsed, unless it is stopped by `myunit_platform_watchdog_stop`
+             before. The callback does not return, it aborts the running test case. A port
+             which cannot leave its timer interrupt this way may reset the platform instead.
 
-#ifndef MYUNIT_CHECKPOINT_SIZE
-#define MYUNIT_CHECKPOINT_SIZE 128 /*!< Defines the default number of checkpoints (128 bits). */
-#endif
+    \param[in] timeout Timeout in milliseconds.
+    \param[in] expired Function to call when the timeout expires.
+*/
+extern void myunit_platform_watchdog_start(uint32_t timeout, void (*expired)(void));
 
 /*!
-    \brief Declares the checkpoint storage array.
-    \details This macro declares an array to store checkpoint bits. The size of the array is calculated based on the number of
-             checkpoints requested, with each checkpoint occupying a single bit. The macro rounds up the size to the nearest byte.
-    \param size The number of checkpoint bits to allocate, rounded to the nearest byte.
+    \brief Disarms the test case watchdog.
 */
-#define MYUNIT_CHECKPOINTS(size) \
-    uint8_t myunit_checkpoints[((size)+7)>>3]
+extern void myunit_platform_watchdog_stop(void);
 
-MYUNIT_CHECKPOINTS(MYUNIT_CHECKPOINT_SIZE);
+/*!
+    \brief Distributes work across isolated workers.
+
+    \details This function calls `work(worker, workers)` once for every worker, each call in its own
+             isolated context (a forked process on Linux), so workers never share state. A port without
+             parallel execution calls `work(0, 1)` in place.
 
+    \param[in] workers Requested number of workers, 0 requests one worker per processor.
+    \param[in] work    Function executed by each worker.
+
+    \return The smallest non-zero result of all workers, or 0 if every worker returned 0.
+*/
+extern uint32_t myunit_platform_parallel(unsigned workers, uint32_t (*work)(unsigned worker, unsigned workers));
 
 /*!
-    \brief Sets a checkpoint at the given index
-    \details This macro stores the current line number in the `myunit_checkpoints` array at the specified index.
-    \param idx The index in the `myunit_checkpoints` array where the checkpoint will be set.
+    \brief Feeds the inputs of a corpus to a function.
+
+    \details This function calls `input` once for every input of the corpus `path`. On Linux a corpus
+             is a directory, each regular file is one input, fed in the order of the file names. A port
+             without a file system may map `path` to inputs linked into the image.
+
+    \param[in] path  Location of the corpus.
+    \param[in] input Function receiving each input.
+
+    \return The number of inputs fed, or a negative value if the corpus does not exist.
 */
-void MYUNIT_CHECKPOINT_SET(uint8_t bit)
-{
-    myunit_checkpoints[((unsigned)(bit))>>3] |= (1<<(((unsigned)(bit))&0x07));
-}
+extern int myunit_platform_corpus(const char *path, void (*input)(const uint8_t *data, size_t size));
 
 /*!
-    \brief Clears a checkpoint at the given index
-    \details This macro resets the value at the specified index in the `myunit_checkpoints` array to 0.
-    \param idx The index in the `myunit_checkpoints` array where the checkpoint will be cleared.
+    \brief Returns a runtime option of the test runner.
+
+    \details Options select test cases and override defaults without rebuilding, see
+             `myunit_testsuite_options`. On Linux options are environment variables. A port without
+             runtime options returns NULL.
+
+    \param[in] name Name of the option, e.g. "MYUNIT_FILTER".
+
+    \return The value of the option, or NULL if it is not set.
 */
-void MYUNIT_CHECKPOINT_CLR(uint8_t bit)
-{
-    myunit_checkpoints[((unsigned)(bit))>>3] &= ~(1<<(((unsigned)(bit))&0x07));
-}
+extern const char *myunit_platform_option(const char *name);
 
+/*!
+    \brief Runs a function in an isolated copy of the test process.
+
+    \details The copy shares nothing with the test process, changes to memory are discarded when `run`
+             returns. Only the `size` bytes at `result` are copied back. On Linux the copy is a forked child,
+             which shares the memory of the test process copy-on-write.
+
+    \param[in] run    Function executed in the copy.
+    \param[in] result Memory copied back from the copy after `run` returned.
+    \param[in] size   Size of `result` in bytes.
+
+    \return 1 if `run` completed, -1 if the copy terminated abnormally, e.g. by a crash, and 0 if the
+            platform does not support isolation. A port without isolation returns 0.
+*/
+extern int myunit_platform_isolated(void (*run)(void), void *result, size_t size);
 
+/*!
+    \brief Reads persistent data of the test runner.
 
+    \details On Linux `name` is a file. A port without persistent storage returns 0.
 
+    \param[in]  name   Name of the data, e.g. the path given by the `MYUNIT_BASELINE` option.
+    \param[out] buffer Buffer receiving the data.
+    \param[in]  size   Size of the buffer in bytes.
+    \param[in]  offset Offset in bytes of the first byte to read.
 
+    \return The number of bytes read, 0 if the data does not exist or ends before `offset`.
+*/
+extern size_t myunit_platform_load(const char *name, void *buffer, size_t size, size_t offset);
 
 /*!
-    \brief Checks if a checkpoint at the given index has been passed.
-    \details This macro checks whether the specified checkpoint bit has been set in the `myunit_checkpoints` array.
-             It returns a non-zero value if the bit is set (i.e., the checkpoint has been passed), and zero if the bit is not set.
-    \param bit The index of the checkpoint to check, where the macro verifies if the checkpoint has been passed.
-    \return A non-zero value if the checkpoint is passed, zero otherwise.
+    \brief Writes persistent data of the test runner.
+
+    \details Replacing data must be atomic, other test processes read either the old or the new data. On
+             Linux a temporary file is renamed over the file.
+
+    \param[in] name   Name of the data.
+    \param[in] data   Data to write.
+    \param[in] size   Size of the data in bytes.
+    \param[in] append `true` appends the data, `false` replaces the existing data.
+
+    \return `true` if the data was written. A port without persistent storage returns `false`.
 */
-bool MYUNIT_CHECKPOINT_PASSED(uint8_t bit)
+extern bool myunit_platform_store(const char *name, const void *data, size_t size, bool append);
+
+/*!
+    \brief Allocates a buffer placed flush against an inaccessible guard region.
+
+    \details On Linux the buffer lies between two `mprotect`ed guard pages, so accessing a byte outside of it
+             faults at once. A port without an MMU returns NULL, the buffer is then protected by canaries.
+
+    \param[in]  size  Size of the buffer in bytes.
+    \param[in]  left  `true` places the buffer at the start of its pages (catches underflows), `false` at their
+                      end (catches overflows).
+    \param[out] guard Size in bytes of each guard region.
+
+    \return The buffer, or NULL if guarded buffers are not supported.
+*/
+extern void *myunit_platform_guarded_alloc(size_t size, bool left, size_t *guard);
+
+/*!
+    \brief Releases a buffer allocated by `myunit_platform_guarded_alloc`.
+*/
+extern void myunit_platform_guarded_free(void *buffer, size_t size, bool left);
+
+/*!
+    \brief Installs the handler of memory access faults.
+
+    \details On a fault the handler calls `fault` with the faulting address. `fault` does not return if it
+             handles the fault, it aborts the running test case. Otherwise the fault is left to the default
+             action of the platform.
+
+    \param[in] fault Function called on a fault.
+*/
+extern void myunit_platform_fault_handler(void (*fault)(void *address));
+
+/*!
+    \brief Starts threads running the same function.
+
+    \details This function starts `threads` threads calling `run(thread)`, each pinned to its own processor
+             as far as there are processors. The threads are started all or none. A port without threads
+             returns `false`.
+
+    \param[in] threads Number of threads.
+    \param[in] run     Function executed by each thread.
+
+    \return `true` if the threads were started.
+*/
+extern bool myunit_platform_threads_start(unsigned threads, void (*run)(unsigned thread));
+
+/*!
+    \brief Waits until all threads started by `myunit_platform_threads_start` and the calling thread arrived.
+*/
+extern void myunit_platform_threads_barrier(void);
+
+/*!
+    \brief Waits until all threads started by `myunit_platform_threads_start` returned.
+*/
+extern void myunit_platform_threads_join(void);
+
+/*!
+    \brief Yields the processor for at least the given time.
+
+    \details Called between two polls of `MYUNIT_ASSERT_EVENTUALLY` and `MYUNIT_ASSERT_ALWAYS`.
+             Bare-metal ports busy-wait on a timer or sleep until the next interrupt,
+             ports running an RTOS or an operating system yield to other tasks.
+
+    \param[in] us Time to yield in microseconds.
+*/
+extern void myunit_platform_delay(uint32_t us);
+
+/*!
+    \brief Starts recording the functions executed.
+
+    \details Used by `MYUNIT_IMPACT` to map each test case to the source files it
+             executes. Functions executed by isolated test cases and by other
+             threads are recorded as well.
+*/
+extern void myunit_platform_trace_begin(void);
+
+/*!
+    \brief Stops recording the functions executed and returns their source files.
+
+    \param[out] files Set to the source files, separated by spaces and terminated, or to `*`
+                      if the functions could not be recorded or resolved.
+    \param[in]  size  Size of `files`.
+
+    \return The length of the text written to `files`.
+*/
+extern size_t myunit_platform_trace_end(char *files, size_t size);
+
+
+/*!
+    \brief Returns the length of the key of a record, its first `key_fields` fields.
+*/
+size_t myunit_records_key(const char *record, unsigned key_fields)
 {
-    return ((unsigned)((myunit_checkpoints[((unsigned)(bit))>>3] & ((1<<(((unsigned)(bit))&0x07)))) > 0));
+    size_t len = 0;
+
+    while (key_fields--)
+    {
+        len += strcspn(record + len," \n");
+        if (key_fields && record[len] == ' ') len++;
+    }
+    return len;
 }
 
+/*!
+    \brief Appends the record following the first `used` bytes of `records` to them and drops an earlier record
+           with the same key.
+    \param len Length of the record including its newline.
+    \param rest Bytes following the first `used` bytes, including the record and excluding the terminator.
+    \return The new number of used bytes.
+*/
+size_t myunit_records_keep(char *records, size_t used, size_t len, size_t rest, unsigned key_fields)
+{
+    char *record = records + used;
+    size_t key = myunit_records_key(record,key_fields);
+    char *line = records;
+
+    while (line < record)
+    {
+        char *end = memchr(line,'\n',(size_t)(record - line));
+        size_t line_len = (end) ? (size_t)(end - line) + 1 : (size_t)(record - line);
+
+        if (!strncmp(line,record,key) && (line[key] == ' ' || line[key] == '\n'))
+        {
+            memmove(line,line + line_len,(size_t)(record - line - line_len) + rest + 1);
+            return used - line_len + len;
+        }
+        line += line_len;
+    }
+    return used + len;
+}
 
 /*!
-    \brief Checks if a checkpoint at the given index has been missed.
-    \details This macro checks whether the specified checkpoint bit has not been set in the `myunit_checkpoints` array.
-             It returns a non-zero value if the bit is not set (i.e., the checkpoint has been missed), and zero if the bit is set.
-    \param bit The index of the checkpoint to check, where the macro verifies if the checkpoint has been missed.
-    \return A non-zero value if the checkpoint is missed, zero otherwise.
+    \brief Loads a file of records which test runs append to, keeping only the latest record of every key.
+    \details Records are lines whose first `key_fields` fields form their key. The file is read in pieces, so
+             it may be longer than the buffer as long as the latest records fit. A last record without a
+             newline, e.g. one still being written, is kept as well. If the file is longer than half the buffer
+             and holds more than twice the bytes of the latest records, it is replaced by them.
+    \param path Name of the file, see `myunit_platform_load`.
+    \param records Buffer receiving the NUL-terminated records.
+    \param size Size of the buffer in bytes.
+    \param key_fields Number of leading fields forming the key of a record.
+    \return `true` if the whole file was read, `false` if the latest records did not fit into the buffer.
 */
-#define MYUNIT_CHECKPOINT_MISSED(bit) (!MYUNIT_CHECKPOINT_PASSED(bit))
+bool myunit_records_load(const char *path, char *records, size_t size, unsigned key_fields)
+{
+    size_t used = 0, offset = 0;
+
+    for (;;)
+    {
+        size_t space = size - 1 - used;
+        size_t count, rest;
+        char probe;
+
+        if (!space)
+        {
+            records[used] = 0;
+            return !myunit_platform_load(path,&probe,1,offset);
+        }
+
+        count = rest = myunit_platform_load(path,records + used,space,offset);
+        records[used + count] = 0;
+        while (rest)
+        {
+            char *end = memchr(records + used,'\n',rest);
+            size_t len;
+
+            // An incomplete record at the end of the buffer is read again with the next piece.
+            if (!end && count == space) break;
+            len = (end) ? (size_t)(end - (records + used)) + 1 : rest;
+            used = myunit_records_keep(records,used,len,rest,key_fields);
+            offset += len;
+            rest -= len;
+        }
+        records[used] = 0;
+
+        if (count < space) break;
+        if (rest == space) return false;
+    }
 
+    if (offset > size / 2 && offset > 2 * used) myunit_platform_store(path,records,used,false);
+    return true;
+}
 
 
-#define MYUNIT_FLAG_SET(bit) MYUNIT_CHECKPOINT_SET(bit)
-#define MYUNIT_FLAG_CLR(bit) MYUNIT_CHECKPOINT_CLR(bit)
-#define MYUNIT_FLAG_IS_SET(bit) MYUNIT_CHECKPOINT_PASSED(bit)
+
+/*!
+    \brief Switches the code under test to the virtual clock.
+    \details From now on `myunit_platform_now()` returns the virtual time, starting at zero. The virtual clock
+             is switched off again automatically at the end of the test case.
+*/
+#define MYUNIT_VIRTUAL_TIME_BEGIN() myunit_vclock_enable(true)
+
+/*!
+    \brief Switches the code under test back to the platform clock.
+*/
+#define MYUNIT_VIRTUAL_TIME_END() myunit_vclock_enable(false)
+
+/*!
+    \brief Advances the virtual time and fires all timers which expire in between.
+    \param ns Number of nanoseconds to advance.
+*/
+#define MYUNIT_ADVANCE_TIME(ns) myunit_vclock_advance(ns)
+
+/*!
+    \brief Schedules a callback on the virtual clock.
+    \param delay Delay in nanoseconds from the current virtual time.
+    \param callback Function of type `void (*)(void *arg)` to call when the timer expires.
+    \param arg Argument passed to the callback.
+    \return A timer handle, or a negative value if no timer is available.
+*/
+#define MYUNIT_SCHEDULE_TIMER(delay,callback,arg) myunit_vclock_schedule(delay,callback,arg)
+
+
+
+#ifndef MYUNIT_CHECKPOINT_SIZE
+#define MYUNIT_CHECKPOINT_SIZE 128 /*!< Defines the default number of checkpoints (128 bits). */
+#endif
+
+/*!
+    \brief Declares the checkpoint storage array.
+    \details This macro declares an array to store checkpoint bits. The size of the array is calculated based on the number of
+             checkpoints requested, with each checkpoint occupying a single bit. The macro rounds up the size to the nearest byte.
+    \param size The number of checkpoint bits to allocate, rounded to the nearest byte.
+*/
+#define MYUNIT_CHECKPOINTS(size) \
+    uint8_t myunit_checkpoints[((size)+7)>>3]
+
+MYUNIT_CHECKPOINTS(MYUNIT_CHECKPOINT_SIZE);
+
+
+/*!
+    \brief Sets a checkpoint at the given index
+    \details This macro stores the current line number in the `myunit_checkpoints` array at the specified index.
+    \param idx The index in the `myunit_checkpoints` array where the checkpoint will be set.
+*/
+void MYUNIT_CHECKPOINT_SET(uint8_t bit)
+{
+    myunit_checkpoints[((unsigned)(bit))>>3] |= (1<<(((unsigned)(bit))&0x07));
+}
+
+/*!
+    \brief Clears a checkpoint at the given index
+    \details This macro resets the value at the specified index in the `myunit_checkpoints` array to 0.
+    \param idx The index in the `myunit_checkpoints` array where the checkpoint will be cleared.
+*/
+void MYUNIT_CHECKPOINT_CLR(uint8_t bit)
+{
+    myunit_checkpoints[((unsigned)(bit))>>3] &= ~(1<<(((unsigned)(bit))&0x07));
+}
+
+
+
+
+
+
+/*!
+    \brief Checks if a checkpoint at the given index has been passed.
+    \details This macro checks whether the specified checkpoint bit has been set in the `myunit_checkpoints` array.
+             It returns a non-zero value if the bit is set (i.e., the checkpoint has been passed), and zero if the bit is not set.
+    \param bit The index of the checkpoint to check, where the macro verifies if the checkpoint has been passed.
+    \return A non-zero value if the checkpoint is passed, zero otherwise.
+*/
+bool MYUNIT_CHECKPOINT_PASSED(uint8_t bit)
+{
+    return ((unsigned)((myunit_checkpoints[((unsigned)(bit))>>3] & ((1<<(((unsigned)(bit))&0x07)))) > 0));
+}
+
+
+/*!
+    \brief Checks if a checkpoint at the given index has been missed.
+    \details This macro checks whether the specified checkpoint bit has not been set in the `myunit_checkpoints` array.
+             It returns a non-zero value if the bit is not set (i.e., the checkpoint has been missed), and zero if the bit is set.
+    \param bit The index of the checkpoint to check, where the macro verifies if the checkpoint has been missed.
+    \return A non-zero value if the checkpoint is missed, zero otherwise.
+*/
+#define MYUNIT_CHECKPOINT_MISSED(bit) (!MYUNIT_CHECKPOINT_PASSED(bit))
+
+
+
+#define MYUNIT_FLAG_SET(bit) MYUNIT_CHECKPOINT_SET(bit)
+#define MYUNIT_FLAG_CLR(bit) MYUNIT_CHECKPOINT_CLR(bit)
+#define MYUNIT_FLAG_IS_SET(bit) MYUNIT_CHECKPOINT_PASSED(bit)
 #define MYUNIT_FLAG_IS_CLR(bit) MYUNIT_CHECKPOINT_MISSED(bit)
 
 
 
 
 /*!
-    \brief Retrieves the total number of checkpoints.
-    \details This macro calculates the total number of checkpoint bits available in the `myunit_checkpoints` array.
-             It determines the size of the array in bytes and multiplies it by 8 to get the total number of bits.
-    \return The total number of available checkpoint bits.
+    \brief Retrieves the total number of checkpoints.
+    \details This macro calculates the total number of checkpoint bits available in the `myunit_checkpoints` array.
+             It determines the size of the array in bytes and multiplies it by 8 to get the total number of bits.
+    \return The total number of available checkpoint bits.
+*/
+#define MYUNIT_CHECKPOINTS_SIZE() ((sizeof(myunit_checkpoints)/sizeof(*myunit_checkpoints))<<3)
+
+/*!
+    \brief Initializes all checkpoints
+    \details This macro initializes all elements in the `myunit_checkpoints` array by clearing each checkpoint.
+             It iterates through the array and resets every index to 0.
+*/
+#define MYUNIT_CHECKPOINS_INIT()   memset(myunit_checkpoints,0x00,sizeof(myunit_checkpoints))
+
+
+#ifndef MYUNIT_FORMAT_BUFFER
+#define MYUNIT_FORMAT_BUFFER 64 /*!< Bytes formatted on the stack by `myunit_printf` before they are written out. */
+#endif
+
+/*!
+    \brief Output of the formatter.
+    \details The formatter fills `buffer`. Once it is full, `write` takes its contents, or the output is
+             truncated if `write` is NULL.
+*/
+typedef struct {
+    char *buffer;                                   /*!< Buffer supplied by the caller */
+    size_t size;                                    /*!< Size of the buffer */
+    size_t len;                                     /*!< Characters in the buffer */
+    int total;                                      /*!< Characters formatted in total */
+    int (*write)(const char *buffer, size_t len);   /*!< Takes the full buffer, NULL to truncate */
+} myunit_format_t;
+
+
+/*!
+    \brief Appends characters to the output of the formatter.
+*/
+void myunit_format_put(myunit_format_t *out, const char *text, size_t len)
+{
+    out->total += (int)len;
+    while (len)
+    {
+        size_t chunk = out->size - out->len;
+
+        if (!chunk)
+        {
+            if (!out->write) return;
+            out->write(out->buffer,out->len);
+            out->len = 0;
+            chunk = out->size;
+        }
+        if (chunk > len) chunk = len;
+        memcpy(out->buffer + out->len,text,chunk);
+        out->len += chunk;
+        text += chunk;
+        len -= chunk;
+    }
+}
+
+/*!
+    \brief Appends a number to the output of the formatter.
+    \param out Output of the formatter.
+    \param value Magnitude of the number.
+    \param negative `true` to prefix a minus sign.
+    \param base 10 or 16.
+    \param width Minimum width, padded with `pad` on the left.
+    \param pad Padding character, `' '` or `'0'`.
+*/
+void myunit_format_number(myunit_format_t *out, unsigned long long value, bool negative, unsigned base,
+                          unsigned width, char pad)
+{
+    char digits[24];
+    char *start = digits + sizeof(digits);
+    size_t len;
+
+    do
+    {
+        *--start = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value);
+    len = (size_t)(digits + sizeof(digits) - start) + (negative ? 1 : 0);
+    if (negative && pad == '0') myunit_format_put(out,"-",1);
+    for (; width > len; width--) myunit_format_put(out,&pad,1);
+    if (negative && pad != '0') myunit_format_put(out,"-",1);
+    myunit_format_put(out,start,(size_t)(digits + sizeof(digits) - start));
+}
+
+/*!
+    \brief Formats text for the output of myunit.
+    \details A reentrant replacement of `vprintf` for the conversions myunit needs: `%s`, `%c`, `%d`, `%i`, `%u`
+             and `%x`, with the length modifiers `l`, `ll` and `z`, an optional `0` flag and width, and `%%`.
+             Other conversions are copied as they are. The formatter keeps no state outside of `out` and
+             needs neither the heap nor floating point.
+    \param out Output of the formatter.
+    \param format Format string.
+    \param args Arguments of the format string.
+    \return The number of characters formatted, including truncated ones.
+*/
+int myunit_vformat(myunit_format_t *out, const char *format, va_list args)
+{
+    while (*format)
+    {
+        const char *start = format;
+        unsigned width = 0;
+        int length = 0;
+        char pad = ' ';
+
+        while (*format && *format != '%') format++;
+        myunit_format_put(out,start,(size_t)(format - start));
+        if (!*format) break;
+
+        start = format++;
+        if (*format == '0') pad = *format++;
+        while (*format >= '0' && *format <= '9') width = width * 10 + (unsigned)(*format++ - '0');
+        while (*format == 'l' || *format == 'z')
+        {
+            length = (*format++ == 'z') ? 3 : length + 1;
+        }
+
+        switch (*format)
+        {
+            case 's':
+            {
+                const char *text = va_arg(args,const char *);
+                if (!text) text = "(null)";
+                myunit_format_put(out,text,strlen(text));
+                break;
+            }
+            case 'c':
+            {
+                char c = (char)va_arg(args,int);
+                myunit_format_put(out,&c,1);
+                break;
+            }
+            case 'd':
+            case 'i':
+            {
+                long long value = (length == 0) ? va_arg(args,int) :
+                                  (length == 1) ? va_arg(args,long) :
+                                  (length == 2) ? va_arg(args,long long) : (long long)va_arg(args,size_t);
+                unsigned long long magnitude = (value < 0) ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+                myunit_format_number(out,magnitude,value < 0,10,width,pad);
+                break;
+            }
+            case 'u':
+            case 'x':
+            {
+                unsigned long long value = (length == 0) ? va_arg(args,unsigned) :
+                                           (length == 1) ? va_arg(args,unsigned long) :
+                                           (length == 2) ? va_arg(args,unsigned long long) : va_arg(args,size_t);
+                myunit_format_number(out,value,false,(*format == 'x') ? 16u : 10u,width,pad);
+                break;
+            }
+            case '%':
+                myunit_format_put(out,"%",1);
+                break;
+            default:
+                if (!*format) format--;
+                myunit_format_put(out,start,(size_t)(format - start + 1));
+                break;
+        }
+        format++;
+    }
+    return out->total;
+}
+
+/*!
+    \brief Formats text into a buffer supplied by the caller, like `snprintf`.
+    \details The text is truncated to `size - 1` characters and always terminated. See `myunit_vformat`.
+    \return The number of characters of the untruncated text.
+*/
+int myunit_format(char *buffer, size_t size, const char *format, ...)
+{
+    myunit_format_t out = {buffer, size ? size - 1 : 0, 0, 0, NULL};
+    va_list args;
+
+    va_start(args,format);
+    myunit_vformat(&out,format,args);
+    va_end(args);
+    if (size) buffer[out.len] = 0;
+    return out.total;
+}
+
+#ifdef MYUNIT_SERIAL
+
+#ifndef MYUNIT_SERIAL_FIFO
+#define MYUNIT_SERIAL_FIFO 16 /*!< Default depth of the TX FIFO of the emulated serial link in bytes. */
+#endif
+
+/*!
+    \brief Model of a serial link with 8N1 framing and a TX FIFO, see `myunit_serial_send`.
+*/
+typedef struct {
+    uint32_t baud;          /*!< Baud rate, 0 if the link is not emulated */
+    uint32_t fifo;          /*!< Depth of the TX FIFO in bytes */
+    bool block;             /*!< Sleep for the stalls instead of accounting them */
+    uint64_t byte_time;     /*!< Nanoseconds to send one byte */
+    uint64_t busy_until;    /*!< Time the last byte in the FIFO is sent */
+    uint64_t stalled;       /*!< Nanoseconds the writer was stalled in total */
+    uint64_t bytes;         /*!< Bytes sent in total */
+} myunit_serial_t;
+
+myunit_serial_t myunit_serial;              /*!< Serial link of the output, `MYUNIT_SERIAL` option */
+
+/*!
+    \brief Sets up a serial link model with all counters zero.
+    \param baud Baud rate, 0 switches the emulation off.
+    \param fifo Depth of the TX FIFO in bytes.
+    \param block `true` sleeps for the stalls, `false` only accounts them.
+*/
+void myunit_serial_init(myunit_serial_t *serial, uint32_t baud, uint32_t fifo, bool block)
+{
+    memset(serial,0x00,sizeof(*serial));
+    if (!baud) return;
+    serial->baud = baud;
+    serial->fifo = fifo;
+    serial->block = block;
+    serial->byte_time = 10000000000ULL / baud;
+}
+
+/*!
+    \brief Sends bytes through a serial link model.
+    \details A byte takes 10 bit times. The bytes are queued behind the bytes still in the FIFO, a write which
+             finds the FIFO full stalls until the bytes which do not fit are sent.
+    \param now Time of the write in nanoseconds.
+    \param len Number of bytes.
+    \return The stall of the write in nanoseconds.
+*/
+uint64_t myunit_serial_send(myunit_serial_t *serial, uint64_t now, size_t len)
+{
+    uint64_t fifo_time = (uint64_t)serial->fifo * serial->byte_time;
+    uint64_t stall;
+
+    if (serial->busy_until < now) serial->busy_until = now;
+    serial->busy_until += (uint64_t)len * serial->byte_time;
+    serial->bytes += len;
+
+    stall = (serial->busy_until > now + fifo_time) ? serial->busy_until - now - fifo_time : 0;
+    serial->stalled += stall;
+    return stall;
+}
+
+/*!
+    \brief Accounts output sent through the emulated serial link of the output.
+    \details Without blocking, the writer runs ahead of the platform clock by the stalls accounted so far.
+    \return `len`.
+*/
+int myunit_serial_output(int len)
+{
+    if (myunit_serial.baud && len > 0)
+    {
+        uint64_t now = myunit_platform_clock() + (myunit_serial.block ? 0 : myunit_serial.stalled);
+        uint64_t stall = myunit_serial_send(&myunit_serial,now,(size_t)len);
+
+        if (myunit_serial.block && stall) myunit_platform_delay((uint32_t)(stall / 1000u));
+    }
+    return len;
+}
+
+/*!
+    \brief Writes output with `myunit_platform_write` after it passed the emulated serial link.
+*/
+int myunit_serial_write(const char *buffer, size_t len)
+{
+    myunit_serial_output((int)len);
+    return myunit_platform_write(buffer,len);
+}
+
+    #define MYUNIT_OUTPUT_WRITE myunit_serial_write
+#else
+    #define MYUNIT_OUTPUT_WRITE myunit_platform_write
+#endif
+
+/*!
+    \brief Formats text and writes it out with `myunit_platform_write`.
+    \details The text is formatted in chunks of `MYUNIT_FORMAT_BUFFER` bytes on the stack. See `myunit_vformat`.
+    \return The number of characters written.
+*/
+int myunit_printf(const char *format, ...)
+{
+    char buffer[MYUNIT_FORMAT_BUFFER];
+    myunit_format_t out = {buffer, sizeof(buffer), 0, 0, MYUNIT_OUTPUT_WRITE};
+    va_list args;
+
+    va_start(args,format);
+    myunit_vformat(&out,format,args);
+    va_end(args);
+    if (out.len) MYUNIT_OUTPUT_WRITE(buffer,out.len);
+    return out.total;
+}
+
+
+/*!
+    \brief Handles printing and assertion logging based on verbosity level
+    \details This block defines macros for printing output and logging assertions based on the verbosity level.
+             When the verbosity is set to a non-silent mode, the macros for printing (`MYUNIT_PRINTF`) and
+             assertion logging (`MYUNIT_ASSERT_PRINTF`) are enabled. Additionally, various tags are defined for
+             marking the start and end of test cases and test suites.
+             - For verbosity levels 1, 2, and 3, different levels of detail are printed for assertions.
+             - If the verbosity level is set to `MYUNIT_SILENT`, no output is generated.
+*/
+/*!
+    \def MYUNIT_PRINTF
+    \brief Macro for printing output during unit tests
+    \details When verbosity is enabled, this macro prints formatted output using `myunit_printf`, or using
+             `myunit_platform_printf` if `MYUNIT_PLATFORM_PRINTF` is defined.
+    \param ... Variable arguments passed to the underlying platform's print function.
+*/
+#if (MYUNIT_VERBOSITY_LEVEL !=  MYUNIT_SILENT)
+
+#if defined(MYUNIT_PLATFORM_PRINTF) && defined(MYUNIT_SERIAL)
+    #define MYUNIT_PRINTF(...) myunit_serial_output(myunit_platform_printf(__VA_ARGS__))
+#elif defined(MYUNIT_PLATFORM_PRINTF)
+    #define MYUNIT_PRINTF(...) myunit_platform_printf(__VA_ARGS__)
+#else
+    #define MYUNIT_PRINTF(...) myunit_printf(__VA_ARGS__)
+#endif
+
+    #define myunit_testcase_begin_tag       "<TCB>" /*!< Tag indicating the start of a test case */
+    #define myunit_testcase_failure_tag     "<TCF>" /*!< Tag indicating a test case failed */
+    #define myunit_testcase_passed_tag      "<TCP>" /*!< Tag indicating a test case failed */
+    #define myunit_testcase_end_tag         "<TCE>" /*!< Tag indicating the end of a test case */
+    #define myunit_testsuite_begin_tag      "<TSB>" /*!< Tag indicating the start of a test suite */
+    #define myunit_testsuite_end_tag        "<TSE>" /*!< Tag indicating the end of a test suite */
+    #define myunit_sequence_begin_tag       "<SQB>" /*!< Tag indicating the start of a test sequence */
+    #define myunit_sequence_end_tag         "<SQE>" /*!< Tag indicating the end of a test sequence */
+    #define myunit_testcase_aggregate_tag   "<TCA>" /*!< Tag summarizing an assertion evaluated repeatedly in a test case */
+    #define myunit_testcase_skipped_tag     "<TCS>" /*!< Tag indicating a test case skipped by fail-fast */
+    #define myunit_testcase_repeat_tag      "<TCR>" /*!< Tag summarizing the repetitions of a test case */
+    #define myunit_testcase_concurrent_tag  "<TCC>" /*!< Tag summarizing one thread of a concurrent stress test */
+    #define myunit_testcase_memory_tag      "<TCM>" /*!< Tag reporting the peak arena usage of a test case */
+    #define myunit_testcase_baseline_tag    "<TCD>" /*!< Tag comparing the durations of a test case to the baseline */
+    #define myunit_testsuite_slowest_tag    "<TSL>" /*!< Tag listing one of the slowest test cases of the test suite */
+    #define myunit_cover_unreached_tag      "<CVU>" /*!< Tag listing a coverage site never reached */
+    #define myunit_cover_summary_tag        "<CVS>" /*!< Tag summarizing the coverage sites */
+    #define myunit_testcase_wait_tag        "<TCW>" /*!< Tag reporting the elapsed time and polls of a failed polling assertion */
+    #define myunit_testsuite_serial_tag     "<TSO>" /*!< Tag reporting the output cost on the emulated serial link */
+    #define myunit_testcase_unaffected_tag  "<TCU>" /*!< Tag indicating a test case not affected by the changed files */
+
+
+    #if ( MYUNIT_VERBOSITY_LEVEL == 1 )
+        #define  MYUNIT_REPORT_PRINTF(result,line,message,test)   \
+            MYUNIT_PRINTF("%s %s %s %d\n",result,myunit_testsuite_name,myunit_testcase_name,line)
+    #elif ( MYUNIT_VERBOSITY_LEVEL == 2 )
+        #define  MYUNIT_REPORT_PRINTF(result,line,message,test)   \
+            MYUNIT_PRINTF("%s %s %s %d \"%s\"\n",result,myunit_testsuite_name,myunit_testcase_name,line,message)
+    #elif ( MYUNIT_VERBOSITY_LEVEL == 3 )
+        #define  MYUNIT_REPORT_PRINTF(result,line,message,test)   \
+            MYUNIT_PRINTF("%s %s %s %d \"%s\" \"%s\"\n",result,myunit_testsuite_name,myunit_testcase_name,line,message,test)
+    #else
+        #error "MYUNIT : Invalid verbose mode"
+    #endif
+
+    #define  MYUNIT_ASSERT_PRINTF(result,message,test)   \
+        MYUNIT_REPORT_PRINTF(result,__LINE__,message,#test)
+
+#else
+    #define MYUNIT_PRINTF(...)    /*!< No-op macro when verbosity is disabled */
+    #define MYUNIT_ASSERT_PRINTF(...)    /*!< No-op macro when verbosity is disabled */
+    #define MYUNIT_REPORT_PRINTF(...)    /*!< No-op macro when verbosity is disabled */
+#endif
+
+
+/*!
+    \brief Configures assertion result printing based on verbosity level.
+    \details This block defines how passed and failed assertions are logged, depending on the `MYUNIT_ASSERT_VERBOSE_LEVEL`:
+             - If verbosity is set to level 2, both passed and failed assertions are printed.
+             - If verbosity is set to level 1, only failed assertions are printed.
+             - If verbosity is set to 0, neither passed nor failed assertions are printed.
+*/
+/*!
+    \def MYUNIT_ASSERT_PASSED_PRINTF
+    \brief Prints a message for a passed assertion if verbosity level is 2.
+    \param assert_result_text The result of the assertion (e.g., "PASS").
+    \param message The custom message associated with the assertion.
+    \param test The actual test condition that was evaluated.
+*/
+/*!
+    \def MYUNIT_ASSERT_FAILED_PRINTF
+    \brief Prints a message for a failed assertion if verbosity level is 2 or 1.
+    \param assert_result_text The result of the assertion (e.g., "FAIL").
+    \param message The custom message associated with the assertion.
+    \param test The actual test condition that was evaluated.
+*/
+/*!
+    \def MYUNIT_REPORT_PASSED_PRINTF
+    \brief Like `MYUNIT_ASSERT_PASSED_PRINTF`, for results which are not produced by `MYUNIT_ASSERT`.
+    \param line The line number to report.
+    \param test The condition as a string.
+*/
+/*!
+    \def MYUNIT_REPORT_FAILED_PRINTF
+    \brief Like `MYUNIT_ASSERT_FAILED_PRINTF`, for results which are not produced by `MYUNIT_ASSERT`.
+    \param line The line number to report.
+    \param test The condition as a string.
+*/
+#if ( MYUNIT_ASSERT_VERBOSE_LEVEL  == 2 )
+    #define MYUNIT_ASSERT_PASSED_PRINTF(assert_result_text,message,test) MYUNIT_ASSERT_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_ASSERT_FAILED_PRINTF(assert_result_text,message,test) MYUNIT_ASSERT_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_REPORT_PASSED_PRINTF(assert_result_text,line,message,test) MYUNIT_REPORT_PRINTF(assert_result_text,line,message,test)
+    #define MYUNIT_REPORT_FAILED_PRINTF(assert_result_text,line,message,test) MYUNIT_REPORT_PRINTF(assert_result_text,line,message,test)
+#elif ( MYUNIT_ASSERT_VERBOSE_LEVEL  == 1 )
+    #define MYUNIT_ASSERT_PASSED_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_ASSERT_FAILED_PRINTF(assert_result_text,message,test) MYUNIT_ASSERT_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_REPORT_PASSED_PRINTF(assert_result_text,line,message,test)
+    #define MYUNIT_REPORT_FAILED_PRINTF(assert_result_text,line,message,test) MYUNIT_REPORT_PRINTF(assert_result_text,line,message,test)
+#else
+    #define MYUNIT_ASSERT_PASSED_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_ASSERT_FAILED_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_REPORT_PASSED_PRINTF(assert_result_text,line,message,test)
+    #define MYUNIT_REPORT_FAILED_PRINTF(assert_result_text,line,message,test)
+#endif
+
+
+#ifndef MYUNIT_ASSERT_AGGREGATE
+#define MYUNIT_ASSERT_AGGREGATE 0 /*!< Results printed per assertion and test case before further results are only counted, 0 prints all results. */
+#endif
+
+#if ( MYUNIT_ASSERT_AGGREGATE > 0 )
+
+/*!
+    \brief Results of one assertion in the running test case.
+    \details Every assertion owns one static instance. It is linked into `myunit_assert_sites` when the assertion
+             is first evaluated in a test case and reset at the end of the test case.
+*/
+typedef struct myunit_assert_site {
+    int line;                               /*!< Line of the assertion */
+    uint32_t hits;                          /*!< Evaluations in the running test case */
+    uint32_t fails;                         /*!< Failed evaluations in the running test case */
+    uint32_t first_fail;                    /*!< Evaluation index of the first failure */
+    uint32_t last_fail;                     /*!< Evaluation index of the last failure */
+    bool listed;                            /*!< Linked into myunit_assert_sites */
+    struct myunit_assert_site *next;        /*!< Next assertion evaluated in the running test case */
+} myunit_assert_site_t;
+
+myunit_assert_site_t *myunit_assert_sites = NULL;  /*!< Assertions evaluated in the running test case. */
+
+/*!
+    \brief Counts an evaluation of an assertion.
+    \param site The assertion.
+    \param passed The result of the evaluation.
+    \return `true` if the result is still to be printed, i.e. it is one of the first `MYUNIT_ASSERT_AGGREGATE`
+            passed or failed results of the assertion in the running test case.
+*/
+bool myunit_assert_site_hit(myunit_assert_site_t *site, bool passed)
+{
+    if (!site->listed)
+    {
+        site->listed = true;
+        site->next = myunit_assert_sites;
+        myunit_assert_sites = site;
+    }
+
+    if (passed) return (++site->hits - site->fails) <= MYUNIT_ASSERT_AGGREGATE;
+
+    if (!site->fails) site->first_fail = site->hits;
+    site->last_fail = site->hits++;
+    return ++site->fails <= MYUNIT_ASSERT_AGGREGATE;
+}
+
+/*!
+    \brief Prints the summaries of the repeatedly evaluated assertions and resets all assertions.
+    \details Called at the end of every test case. Prints a `<TCA>` record with the line, the number of
+             evaluations and failures and the indices of the first and last failed evaluation for every
+             assertion evaluated more than once. Passed-only assertions are left out unless all assertions
+             are printed.
+*/
+void myunit_assert_sites_report(void)
+{
+    while (myunit_assert_sites)
+    {
+        myunit_assert_site_t *site = myunit_assert_sites;
+
+#if ( MYUNIT_ASSERT_VERBOSE_LEVEL > 0 )
+        if (site->hits > 1 && (site->fails || MYUNIT_ASSERT_VERBOSE_LEVEL == 2))
+        {
+            MYUNIT_PRINTF("%s %s %s %d %u %u %d %d\n",myunit_testcase_aggregate_tag,myunit_testsuite_name,myunit_testcase_name,
+                          site->line,(unsigned)site->hits,(unsigned)site->fails,
+                          (site->fails) ? (int)site->first_fail : -1,(site->fails) ? (int)site->last_fail : -1);
+        }
+#endif
+
+        myunit_assert_sites = site->next;
+        site->hits = site->fails = 0;
+        site->listed = false;
+    }
+}
+
+    #define MYUNIT_ASSERT_SITE() static myunit_assert_site_t myunit_assert_site = {__LINE__,0,0,0,0,false,NULL}
+    #define MYUNIT_ASSERT_SITE_HIT(passed) myunit_assert_site_hit(&myunit_assert_site,passed)
+    #define MYUNIT_ASSERT_SITES_REPORT() myunit_assert_sites_report()
+#else
+    #define MYUNIT_ASSERT_SITE()
+    #define MYUNIT_ASSERT_SITE_HIT(passed) true
+    #define MYUNIT_ASSERT_SITES_REPORT()
+#endif
+
+
+/*!
+    \brief Registry of the mocks used in the running test case, see `myunit_mock.h`.
+    \details Each mock starts with this header. A mock is linked into `myunit_mocks` when it is first called
+             or configured in a test case and reset at the end of the test case.
+*/
+typedef struct myunit_mock {
+    struct myunit_mock *next;               /*!< Next mock used in the running test case */
+    bool listed;                            /*!< Linked into myunit_mocks */
+    size_t size;                            /*!< Size of the mock including this header */
+} myunit_mock_t;
+
+myunit_mock_t *myunit_mocks = NULL;         /*!< Mocks used in the running test case. */
+uint32_t myunit_mock_sequence;              /*!< Calls of all mocks in the running test case. */
+
+/*!
+    \brief Links a mock into `myunit_mocks`, so it is reset at the end of the test case.
+*/
+void myunit_mock_register(myunit_mock_t *mock)
+{
+    if (mock->listed) return;
+    mock->listed = true;
+    mock->next = myunit_mocks;
+    myunit_mocks = mock;
+}
+
+/*!
+    \brief Clears the state of a mock following its header.
+*/
+void myunit_mock_reset(myunit_mock_t *mock)
+{
+    memset((uint8_t*)mock + sizeof(myunit_mock_t),0,mock->size - sizeof(myunit_mock_t));
+}
+
+/*!
+    \brief Resets all mocks used in the running test case.
+*/
+void myunit_mocks_reset(void)
+{
+    while (myunit_mocks)
+    {
+        myunit_mock_t *mock = myunit_mocks;
+
+        myunit_mocks = mock->next;
+        myunit_mock_reset(mock);
+        mock->listed = false;
+        mock->next = NULL;
+    }
+    myunit_mock_sequence = 0;
+}
+
+
+/*!
+    \brief Defines a test suite and its execution entry point.
+    \details This macro creates a test suite by defining a function that will execute the test cases
+             in the suite. It also sets up the `main` function to run the test suite, returning
+             `EXIT_SUCCESS` if all tests pass and `EXIT_FAILURE` if any test fails.
+    \param name The name of the test suite, which is used to generate the function names and variables associated with the suite.
+    \note The macro generates a function `name##_exec` where the test suite's logic is implemented.
+    \note In fuzz builds (`MYUNIT_FUZZ_LIBFUZZER` or `MYUNIT_FUZZ_AFL`), the fuzzer entry point of
+          `myunit_fuzz.h` is generated instead of `main`.
+*/
+#if defined(MYUNIT_FUZZ_LIBFUZZER) || defined(MYUNIT_FUZZ_AFL)
+#define MYUNIT_TESTSUITE(name)                                              \
+    static const char *const_myunit_testsuite_name = #name;                 \
+    MYUNIT_FUZZ_ENTRY()                                                     \
+    int name##_exec();                                                      \
+    int name##_exec()
+#else
+#define MYUNIT_TESTSUITE(name)                                              \
+    static const char *const_myunit_testsuite_name = #name;                 \
+    int name##_exec();                                                      \
+    int main() { return (name##_exec())?EXIT_FAILURE:EXIT_SUCCESS; }        \
+    int name##_exec()
+#endif
+
+/*!
+    \brief Applies the runtime options of the test runner.
+    \details Reads the options through `myunit_platform_option`:
+             - `MYUNIT_FILTER`: executes only the test case of this name, or all rows of the parameterized test case.
+             - `MYUNIT_TIMEOUT`: default test case timeout in milliseconds, see `MYUNIT_SET_TIMEOUT`.
+             - `MYUNIT_LIST`: prints the inventory instead of executing the test cases, if built with `MYUNIT_INVENTORY`.
+             - `MYUNIT_BASELINE`: compares the durations of repeated test cases to this baseline, if built with
+               `MYUNIT_BASELINE`.
+             - `MYUNIT_BASELINE_SAVE`: appends the durations of repeated test cases to this baseline, if built with
+               `MYUNIT_BASELINE`.
+             - `MYUNIT_HISTORY`: history file of the test suite, if built with `MYUNIT_HISTORY`. It is read by
+               `myunit_history_load` when the test suite begins.
+             - `MYUNIT_IMPACT_RECORD`, `MYUNIT_IMPACT` and `MYUNIT_CHANGED`: impact map to write, impact map to read
+               and changed source files, if built with `MYUNIT_IMPACT`. They are read by `myunit_impact_load`
+               when the test suite begins.
+             - `MYUNIT_SERIAL`, `MYUNIT_SERIAL_FIFO` and `MYUNIT_SERIAL_BLOCK`: baud rate, TX FIFO depth and
+               blocking of the emulated serial link of the output, if built with `MYUNIT_SERIAL`.
+*/
+void myunit_testsuite_options(void)
+{
+    const char *option;
+
+    myunit_testsuite_filter = myunit_platform_option("MYUNIT_FILTER");
+    if ((option = myunit_platform_option("MYUNIT_TIMEOUT")) != NULL) myunit_testsuite_timeout = (uint32_t)strtoul(option,NULL,10);
+#ifdef MYUNIT_BASELINE
+    myunit_baseline_path = myunit_platform_option("MYUNIT_BASELINE");
+    myunit_baseline_save_path = myunit_platform_option("MYUNIT_BASELINE_SAVE");
+#endif
+#ifdef MYUNIT_SERIAL
+    if ((option = myunit_platform_option("MYUNIT_SERIAL")) != NULL)
+    {
+        const char *fifo = myunit_platform_option("MYUNIT_SERIAL_FIFO");
+        const char *block = myunit_platform_option("MYUNIT_SERIAL_BLOCK");
+
+        myunit_serial_init(&myunit_serial,(uint32_t)strtoul(option,NULL,10),
+                           fifo ? (uint32_t)strtoul(fifo,NULL,10) : MYUNIT_SERIAL_FIFO,block && strcmp(block,"0"));
+    }
+#endif
+}
+
+/*!
+    \brief Marks the beginning of a test suite.
+    \details This macro initializes the platform and test suite setup functions, assigns the test suite name, and
+             resets various counters for assertions and test cases. It also prints a message indicating the start
+             of the test suite, including the file name, date, and time of the test suite execution.
+    \note The printed output includes:
+          - Test suite begin tag (`myunit_testsuite_begin_tag`)
+          - Test suite name (`myunit_testsuite_name`)
+          - The current file name (`__FILE__`)
+          - The current date (`__DATE__`)
+          - The current time (`__TIME__`)
+*/
+#define MYUNIT_TESTSUITE_BEGIN()                                                        \
+    {                                                                                   \
+        myunit_platform_init();                                                         \
+        myunit_testsuite_options();                                                     \
+        MYUNIT_HISTORY_LOAD(const_myunit_testsuite_name);                               \
+        MYUNIT_IMPACT_LOAD(const_myunit_testsuite_name);                                \
+        MYUNIT_INVENTORY_LIST();                                                        \
+        myunit_testsuite_setup();                                                       \
+        myunit_testsuite_name = (char*)const_myunit_testsuite_name;                     \
+        myunit_testsuite_assert_fail_count = 0;                                         \
+        myunit_testsuite_assert_success_count = 0;                                      \
+        myunit_testcase_success_count = 0;                                              \
+        myunit_testcase_fail_count = 0;                                                 \
+        myunit_testcase_skip_count = 0;                                                 \
+        myunit_testsuite_stopped = false;                                               \
+        MYUNIT_PRINTF("%s %s \"%s\" \"%s\" \"%s\"\n",                                   \
+        myunit_testsuite_begin_tag,myunit_testsuite_name,__FILE__,__DATE__,__TIME__);   \
+        MYUNIT_HISTORY_PASS_START();
+
+#ifdef MYUNIT_SERIAL
+/*!
+    \brief Prints the `<TSO>` record of the emulated serial link: baud rate, FIFO depth, bytes sent, and the
+           transmission time and stall time in microseconds.
+*/
+void myunit_serial_report(void)
+{
+    if (!myunit_serial.baud) return;
+    MYUNIT_PRINTF("%s %s %u %u %llu %llu %llu\n",myunit_testsuite_serial_tag,myunit_testsuite_name,
+                  (unsigned)myunit_serial.baud,(unsigned)myunit_serial.fifo,(unsigned long long)myunit_serial.bytes,
+                  (unsigned long long)(myunit_serial.bytes * myunit_serial.byte_time / 1000u),
+                  (unsigned long long)(myunit_serial.stalled / 1000u));
+}
+
+    #define MYUNIT_SERIAL_REPORT() myunit_serial_report()
+#else
+    #define MYUNIT_SERIAL_REPORT()
+#endif
+
+/*!
+    \brief Marks the end of a test suite and prints the summary.
+    \details This macro concludes the execution of a test suite by printing the results, including the number of failed
+             and successful test cases and assertions. It then calls the teardown function for the test suite and
+             deinitializes the platform. The macro finally returns the number of failed test cases as the function result.
+    \note The printed output includes:
+          - Test suite end tag (`myunit_testsuite_end_tag`)
+          - Test suite name (`myunit_testsuite_name`)
+          - Number of failed test cases (`myunit_testcase_fail_count`)
+          - Number of failed assertions (`myunit_testsuite_assert_fail_count`)
+          - Number of successful test cases (`myunit_testcase_success_count`)
+          - Number of successful assertions (`myunit_testsuite_assert_success_count`)
+    \note If built with `MYUNIT_SERIAL`, the `<TSO>` record of the emulated serial link follows the summary.
+*/
+#define MYUNIT_TESTSUITE_END()                          \
+        MYUNIT_HISTORY_PASS_END();                      \
+        MYUNIT_COVER_REPORT();                          \
+        MYUNIT_PRINTF("%s %s %d %d %d %d\n",            \
+            myunit_testsuite_end_tag,                   \
+            myunit_testsuite_name,                      \
+            myunit_testcase_fail_count,                 \
+            myunit_testsuite_assert_fail_count,         \
+            myunit_testcase_success_count,              \
+            myunit_testsuite_assert_success_count);     \
+        MYUNIT_SERIAL_REPORT();                         \
+        myunit_testsuite_teardown();                    \
+        myunit_platform_deinit();                       \
+        return (myunit_testcase_fail_count);            \
+    }
+
+/*!
+    \brief Defines a test case within a test suite.
+    \details This macro creates a function for the specified test case. Each test case is implemented as a function
+             with the name `myunit_testcase_##name`, where `name` is the provided name of the test case.
+    \param name The name of the test case, which will be used to generate the function name.
+    \note The actual implementation of the test case should be placed inside the generated function.
+    \note With `MYUNIT_INVENTORY` defined, the test case is also added to the inventory.
+*/
+#define MYUNIT_TESTCASE(name)  MYUNIT_INVENTORY_TESTCASE(name) void myunit_testcase_##name(void)
+
+
+/*!
+    \brief Executes a specific test case within a test suite.
+    \details This macro calls the `myunit_exec_testcase` function to execute a test case, passing the function pointer
+             to the test case and its name as a string for logging purposes.
+    \param name The name of the test case to be executed. This should correspond to the name used in `MYUNIT_TESTCASE`.
+*/
+
+#define MYUNIT_EXEC_TESTCASE(name) \
+        myunit_exec_testcase(#name, myunit_testcase_##name)
+
+/*!
+    \brief Executes a specific test case with its own timeout.
+    \details Like `MYUNIT_EXEC_TESTCASE`, but the test case is aborted and counted as failed if it
+             does not complete within `timeout` milliseconds, regardless of the test suite default.
+    \param name The name of the test case to be executed.
+    \param timeout Timeout in milliseconds, 0 disables the watchdog for this test case.
+*/
+#define MYUNIT_EXEC_TESTCASE_TIMEOUT(name,timeout) \
+        myunit_exec_testcase_timeout(#name, myunit_testcase_##name, timeout)
+
+
+#define MYUNIT_ABORT_TIMEOUT    1   /*!< \brief Test case aborted by the watchdog */
+#define MYUNIT_ABORT_REQUIRE    2   /*!< \brief Test case aborted by a failed `MYUNIT_REQUIRE` */
+#define MYUNIT_ABORT_FAIL_FAST  3   /*!< \brief Test case aborted by a fail-fast limit */
+#define MYUNIT_ABORT_GUARD      4   /*!< \brief Test case aborted by an access to a guard region */
+#define MYUNIT_ABORT_ARENA      5   /*!< \brief Test case aborted by an exhausted arena */
+
+
+/*!
+    \brief Aborts the running test case when the watchdog expires.
+    \details Passed to `myunit_platform_watchdog_start`. It returns to `myunit_exec_testcase_timeout`,
+             which reports the timeout and continues with the next test case.
+*/
+void myunit_testcase_watchdog_expired(void)
+{
+    MYUNIT_LONGJMP(myunit_testcase_jmp_buf,MYUNIT_ABORT_TIMEOUT);
+}
+
+
+/*!
+    \brief Aborts the running test case, see `MYUNIT_REQUIRE`.
+    \details Does nothing outside of a test case, e.g. in a fixture teardown.
+*/
+void myunit_testcase_abort(int reason)
+{
+    if (myunit_testcase_running) MYUNIT_LONGJMP(myunit_testcase_jmp_buf,reason);
+}
+
+
+/*!
+    \brief Checks the fail-fast limits after a failure.
+    \details Stops the test suite if a limit set by `MYUNIT_SET_FAIL_FAST` is reached by the failures since it
+             was set. A running test case is aborted right away, otherwise the remaining test cases are skipped.
+             Failed assertions of the running test case count towards the limit, failed assertions inside a
+             sequence do not.
+*/
+void myunit_testsuite_fail_fast(void)
+{
+    uint32_t testcases = (uint32_t)(myunit_testcase_fail_count - myunit_testsuite_fail_fast_testcases);
+    uint32_t asserts = (uint32_t)(myunit_testsuite_assert_fail_count + myunit_testcase_assert_fail_count -
+                                  myunit_testsuite_fail_fast_asserts);
+
+    if ((myunit_testsuite_max_failed_testcases && testcases >= myunit_testsuite_max_failed_testcases) ||
+        (myunit_testsuite_max_failed_asserts && asserts >= myunit_testsuite_max_failed_asserts))
+    {
+        myunit_testsuite_stopped = true;
+        myunit_testcase_abort(MYUNIT_ABORT_FAIL_FAST);
+    }
+}
+
+
+#ifndef MYUNIT_GUARD_BUFFERS
+#define MYUNIT_GUARD_BUFFERS 8 /*!< Guarded buffers a test case can allocate. */
+#endif
+
+#ifndef MYUNIT_GUARD_POOL
+#ifdef MYUNIT_GUARD_CANARIES
+#define MYUNIT_GUARD_POOL 4096 /*!< Bytes of the pool holding buffers protected by canaries, including the canaries. */
+#else
+#define MYUNIT_GUARD_POOL 0    /*!< No pool unless opted in, buffers are protected by guard pages only. */
+#endif
+#endif
+
+#ifndef MYUNIT_GUARD_CANARY_SIZE
+#define MYUNIT_GUARD_CANARY_SIZE 8 /*!< Canary bytes on each side of a buffer protected by canaries. */
+#endif
+
+/*!
+    \brief A guarded buffer of the running test case.
+*/
+typedef struct {
+    uint8_t *buffer;                        /*!< Start of the buffer */
+    size_t size;                            /*!< Size of the buffer */
+    size_t guard;                           /*!< Size of each guard page, 0 if protected by canaries */
+    bool left;                              /*!< Placed at the start of its pages */
+} myunit_guard_t;
+
+myunit_guard_t myunit_guards[MYUNIT_GUARD_BUFFERS];     /*!< Guarded buffers of the running test case. */
+uint32_t myunit_guard_count;                            /*!< Guarded buffers in use. */
+#if MYUNIT_GUARD_POOL > 0
+uint8_t myunit_guard_pool[MYUNIT_GUARD_POOL];           /*!< Buffers protected by canaries. */
+#endif
+size_t myunit_guard_pool_used;                          /*!< Bytes of the pool in use. */
+
+/*!
+    \brief Allocates a buffer whose first byte past its end is inaccessible.
+    \details Writing or reading past the end aborts the test case with the message "GUARD", see
+             `myunit_guard_alloc`.
+    \param size Size of the buffer in bytes.
+*/
+#define MYUNIT_GUARDED_BUFFER(size) myunit_guard_alloc(size,false)
+
+/*!
+    \brief Allocates a buffer whose last byte before its start is inaccessible.
+    \param size Size of the buffer in bytes.
+*/
+#define MYUNIT_GUARDED_BUFFER_LEFT(size) myunit_guard_alloc(size,true)
+
+
+/*!
+    \brief Canary byte at offset `idx` of a canary.
+*/
+uint8_t myunit_guard_canary(size_t idx)
+{
+    return (uint8_t)(0xA5u ^ (idx * 0x3Bu));
+}
+
+/*!
+    \brief Aborts the running test case on an access to a guard page.
+    \details Passed to `myunit_platform_fault_handler`. Faults next to a guarded buffer while a test case runs are
+             reported by a failed assertion with the message "GUARD" on the line of the last passed assertion.
+             Returns only if the fault is left to the platform.
+*/
+void myunit_guard_fault(void *address)
+{
+    uint8_t *fault = (uint8_t*)address;
+    uint32_t idx;
+
+    if (!myunit_testcase_running) return;
+
+    for (idx = 0; idx < myunit_guard_count; idx++)
+    {
+        myunit_guard_t *guard = &myunit_guards[idx];
+        size_t reach = guard->guard + guard->size;
+
+        if (!guard->guard) continue;
+        if (fault < guard->buffer && fault >= guard->buffer - reach)
+        {
+            myunit_testcase_assert_fail_count++;
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"GUARD","buffer underflow");
+        }
+        else if (fault >= guard->buffer + guard->size && fault < guard->buffer + guard->size + reach)
+        {
+            myunit_testcase_assert_fail_count++;
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"GUARD","buffer overflow");
+        }
+        else continue;
+
+        MYUNIT_FAILURE_ACTION();
+        myunit_testcase_abort(MYUNIT_ABORT_GUARD);
+    }
+}
+
+/*!
+    \brief Allocates a guarded buffer for the running test case.
+    \details The buffer is placed flush against a guard page by `myunit_platform_guarded_alloc`. Without guard
+             pages, or if `MYUNIT_GUARD_CANARIES` is defined, it is taken from a static pool of
+             `MYUNIT_GUARD_POOL` bytes and surrounded by canaries, which are checked when the test case ends. The
+             pool is only allocated if `MYUNIT_GUARD_CANARIES` is defined or `MYUNIT_GUARD_POOL` is set. The buffers are released when the test case
+             ends. Running out of buffers fails the test case with the message "GUARD".
+    \param size Size of the buffer in bytes.
+    \param left `true` to detect underflows by a guard page before the buffer, `false` to detect overflows.
+    \return The buffer, or NULL if no buffer is left.
+*/
+void *myunit_guard_alloc(size_t size, bool left)
+{
+    myunit_guard_t *guard;
+#ifndef MYUNIT_GUARD_CANARIES
+    static bool handler_installed = false;
+#endif
+
+    if (myunit_guard_count == MYUNIT_GUARD_BUFFERS) guard = NULL;
+    else guard = &myunit_guards[myunit_guard_count];
+
+#ifndef MYUNIT_GUARD_CANARIES
+    if (guard && (guard->buffer = (uint8_t*)myunit_platform_guarded_alloc(size,left,&guard->guard)) != NULL)
+    {
+        if (!handler_installed) myunit_platform_fault_handler(myunit_guard_fault);
+        handler_installed = true;
+    }
+    else
+#endif
+#if MYUNIT_GUARD_POOL > 0
+    if (guard)
+    {
+        /* Canaries on both sides, buffers aligned to 8 bytes */
+        size_t start = (myunit_guard_pool_used + MYUNIT_GUARD_CANARY_SIZE + 7u) & ~(size_t)7u, idx;
+
+        if (start + size + MYUNIT_GUARD_CANARY_SIZE > MYUNIT_GUARD_POOL) guard = NULL;
+        else
+        {
+            guard->buffer = &myunit_guard_pool[start];
+            guard->guard = 0;
+            for (idx = 0; idx < MYUNIT_GUARD_CANARY_SIZE; idx++)
+            {
+                *(guard->buffer - 1 - idx) = myunit_guard_canary(idx);
+                guard->buffer[size + idx] = myunit_guard_canary(idx);
+            }
+            myunit_guard_pool_used = start + size + MYUNIT_GUARD_CANARY_SIZE;
+        }
+    }
+#else
+    guard = NULL;
+#endif
+
+    if (!guard)
+    {
+        myunit_testcase_assert_fail_count++;
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"GUARD","out of guarded buffers");
+        MYUNIT_FAILURE_ACTION();
+        return NULL;
+    }
+
+    guard->size = size;
+    guard->left = left;
+    myunit_guard_count++;
+    return guard->buffer;
+}
+
+/*!
+    \brief Releases the guarded buffers of the test case.
+    \details Damaged canaries are reported by a failed assertion with the message "CANARY" on the line of the
+             last passed assertion.
+*/
+void myunit_guards_release(void)
+{
+    uint32_t idx;
+    size_t pos;
+
+    for (idx = 0; idx < myunit_guard_count; idx++)
+    {
+        myunit_guard_t *guard = &myunit_guards[idx];
+        bool underflow = false, overflow = false;
+
+        if (guard->guard)
+        {
+            myunit_platform_guarded_free(guard->buffer,guard->size,guard->left);
+            continue;
+        }
+
+        for (pos = 0; pos < MYUNIT_GUARD_CANARY_SIZE; pos++)
+        {
+            if (*(guard->buffer - 1 - pos) != myunit_guard_canary(pos)) underflow = true;
+            if (guard->buffer[guard->size + pos] != myunit_guard_canary(pos)) overflow = true;
+        }
+        if (underflow || overflow)
+        {
+            myunit_testcase_assert_fail_count++;
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"CANARY",
+                                        overflow ? "buffer overflow" : "buffer underflow");
+            MYUNIT_FAILURE_ACTION();
+        }
+    }
+    myunit_guard_count = 0;
+    myunit_guard_pool_used = 0;
+}
+
+
+#ifdef MYUNIT_ARENA
+
+#ifndef MYUNIT_ARENA_SIZE
+#define MYUNIT_ARENA_SIZE 1024 /*!< Bytes of the arena shared by the test cases, see MYUNIT_ALLOC */
+#endif
+
+uint8_t myunit_arena[MYUNIT_ARENA_SIZE];    /*!< Scratch memory of the running test case. */
+size_t myunit_arena_used;                   /*!< Bytes of the arena in use. */
+size_t myunit_arena_peak;                   /*!< Most bytes of the arena in use by the current test case. */
+
+/*!
+    \brief Allocates scratch memory for the running test case.
+    \details Available if built with `MYUNIT_ARENA`. The memory is taken from the arena in constant time and
+             given back when the test case ends.
+             Running out of arena fails the test case with the message "ARENA" and aborts it.
+    \param size Size in bytes.
+    \param align Alignment in bytes, a power of two.
+    \return The memory, NULL if the arena is exhausted outside of a test case.
+*/
+#define MYUNIT_ALLOC(size,align) myunit_arena_alloc(size,align)
+
+
+/*!
+    \brief Allocates memory from the arena, see `MYUNIT_ALLOC`.
+*/
+void *myunit_arena_alloc(size_t size, size_t align)
+{
+    uintptr_t base = (uintptr_t)myunit_arena;
+    uintptr_t start;
+
+    if (align == 0) align = 1;
+    start = (base + myunit_arena_used + align - 1) & ~(uintptr_t)(align - 1);
+
+    if (start - base > MYUNIT_ARENA_SIZE || size > MYUNIT_ARENA_SIZE - (start - base))
+    {
+        myunit_testcase_assert_fail_count++;
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"ARENA","arena exhausted");
+        MYUNIT_FAILURE_ACTION();
+        myunit_testcase_abort(MYUNIT_ABORT_ARENA);
+        return NULL;
+    }
+
+    myunit_arena_used = (size_t)(start - base) + size;
+    if (myunit_arena_used > myunit_arena_peak) myunit_arena_peak = myunit_arena_used;
+    return (void*)start;
+}
+
+/*!
+    \brief Gives all memory of the arena back.
+*/
+void myunit_arena_reset(void)
+{
+    myunit_arena_used = 0;
+}
+
+/*!
+    \brief Prints the `<TCM>` record of the current test case if it used the arena.
+*/
+void myunit_arena_report(void)
+{
+    if (!myunit_arena_peak) return;
+    MYUNIT_PRINTF("%s %s %s %u %u\n",myunit_testcase_memory_tag,myunit_testsuite_name,myunit_testcase_name,
+                  (unsigned)myunit_arena_peak,(unsigned)MYUNIT_ARENA_SIZE);
+}
+
+    #define MYUNIT_ARENA_BEGIN()    do{myunit_arena_peak = 0;}while(0)
+    #define MYUNIT_ARENA_RESET()    myunit_arena_reset()
+    #define MYUNIT_ARENA_REPORT()   myunit_arena_report()
+#else
+    #define MYUNIT_ARENA_BEGIN()
+    #define MYUNIT_ARENA_RESET()
+    #define MYUNIT_ARENA_REPORT()
+#endif
+
+
+/*!
+    \brief Runs a test case once in the test process.
+    \details Guards the fixture setup and the test case by the platform watchdog if `timeout` is not zero and
+             handles an abort by the watchdog, `MYUNIT_REQUIRE`, a guard page or a fail-fast limit. Afterwards the
+             fixture teardown runs, the guarded buffers and the arena are released, the virtual clock is switched
+             off and the mocks are reset.
+    \param testcase A pointer to the function representing the test case to be executed.
+    \param timeout Timeout in milliseconds, 0 disables the watchdog.
+*/
+void myunit_testcase_run_inplace(void(*testcase)(), uint32_t timeout)
+{
+    int fail_count = myunit_testcase_assert_fail_count;
+
+    switch (MYUNIT_SETJMP(myunit_testcase_jmp_buf))
+    {
+    case 0:
+        if(timeout) myunit_platform_watchdog_start(timeout,myunit_testcase_watchdog_expired);
+        myunit_testcase_running = true;
+        if(myunit_testcase_setup) myunit_testcase_setup();
+        testcase();
+        myunit_testcase_running = false;
+        break;
+    case MYUNIT_ABORT_TIMEOUT:
+        myunit_testcase_running = false;
+        myunit_testcase_assert_fail_count++;
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"TIMEOUT","watchdog expired");
+        MYUNIT_FAILURE_ACTION();
+        break;
+    case MYUNIT_ABORT_REQUIRE:
+        myunit_testcase_running = false;
+        /* A REQUIRE failed inside a sequence is only counted by the sequence */
+        if (myunit_testcase_assert_fail_count == fail_count) myunit_testcase_assert_fail_count++;
+        break;
+    default:
+        myunit_testcase_running = false;
+        break;
+    }
+    if(timeout) myunit_platform_watchdog_stop();
+    if(myunit_testcase_teardown) myunit_testcase_teardown();
+    myunit_guards_release();
+    MYUNIT_ARENA_RESET();
+    if(myunit_vclock_enabled()) myunit_vclock_enable(false);
+    myunit_mocks_reset();
+}
+
+
+/*!
+    \brief Results of a test case run in an isolated copy of the test process.
+*/
+typedef struct {
+    int fail_count;                         /*!< myunit_testcase_assert_fail_count after the run */
+    int success_count;                      /*!< myunit_testcase_assert_success_count after the run */
+    int last_line;                          /*!< myunit_testcase_last_line after the run */
+    bool stopped;                           /*!< myunit_testsuite_stopped after the run */
+#ifdef MYUNIT_ARENA
+    size_t arena_peak;                      /*!< myunit_arena_peak after the run */
+#endif
+#ifdef MYUNIT_SERIAL
+    myunit_serial_t serial;                 /*!< myunit_serial after the run */
+#endif
+} myunit_isolated_t;
+
+myunit_isolated_t myunit_isolated;          /*!< Results of the isolated run. */
+void (*myunit_isolated_testcase)();         /*!< Test case of the isolated run. */
+uint32_t myunit_isolated_timeout;           /*!< Timeout of the isolated run. */
+
+/*!
+    \brief Runs the test case in the isolated copy and collects its results.
+*/
+void myunit_testcase_isolated(void)
+{
+    myunit_testcase_run_inplace(myunit_isolated_testcase,myunit_isolated_timeout);
+    myunit_isolated.fail_count = myunit_testcase_assert_fail_count;
+    myunit_isolated.success_count = myunit_testcase_assert_success_count;
+    myunit_isolated.last_line = myunit_testcase_last_line;
+    myunit_isolated.stopped = myunit_testsuite_stopped;
+#ifdef MYUNIT_ARENA
+    myunit_isolated.arena_peak = myunit_arena_peak;
+#endif
+#ifdef MYUNIT_SERIAL
+    myunit_isolated.serial = myunit_serial;
+#endif
+}
+
+/*!
+    \brief Runs a test case once.
+    \details With isolation set by `MYUNIT_SET_ISOLATION`, the test case runs in an isolated copy of the test
+             process and its results are taken over. A test case whose copy terminates abnormally is reported
+             by a failed assertion with the message "CRASH" on the line of the last passed assertion. Otherwise
+             the snapshot is restored and the test case runs in place.
+    \param testcase A pointer to the function representing the test case to be executed.
+    \param timeout Timeout in milliseconds, 0 disables the watchdog.
+*/
+void myunit_testcase_run(void(*testcase)(), uint32_t timeout)
+{
+    if (myunit_testsuite_isolation)
+    {
+        myunit_isolated_testcase = testcase;
+        myunit_isolated_timeout = timeout;
+
+        switch (myunit_platform_isolated(myunit_testcase_isolated,&myunit_isolated,sizeof(myunit_isolated)))
+        {
+        case 1:
+            myunit_testcase_assert_fail_count = myunit_isolated.fail_count;
+            myunit_testcase_assert_success_count = myunit_isolated.success_count;
+            myunit_testcase_last_line = myunit_isolated.last_line;
+            myunit_testsuite_stopped = myunit_isolated.stopped;
+#ifdef MYUNIT_ARENA
+            myunit_arena_peak = myunit_isolated.arena_peak;
+#endif
+#ifdef MYUNIT_SERIAL
+            myunit_serial = myunit_isolated.serial;
+#endif
+            return;
+        case -1:
+            myunit_testcase_assert_fail_count++;
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"CRASH","test case terminated");
+            MYUNIT_FAILURE_ACTION();
+            return;
+        default:
+            break;
+        }
+    }
+
+    myunit_snapshot_restore();
+    myunit_testcase_run_inplace(testcase,timeout);
+}
+
+
+/*!
+    \brief Returns the median of the first `count` durations in `samples`, sorting them.
+*/
+uint32_t myunit_testcase_median(uint32_t *samples, uint32_t count)
+{
+    uint32_t i, j;
+
+    for (i = 1; i < count; i++)
+    {
+        uint32_t value = samples[i];
+        for (j = i; j > 0 && samples[j - 1] > value; j--) samples[j] = samples[j - 1];
+        samples[j] = value;
+    }
+    return (count) ? samples[count / 2] : 0;
+}
+
+
+#ifdef MYUNIT_BASELINE
+
+/*!
+    \brief Square root by Newton's method, avoiding a dependency on the math library.
+*/
+double myunit_baseline_sqrt(double value)
+{
+    double root = value;
+    int idx;
+
+    if (value <= 0) return 0;
+    for (idx = 0; idx < 32; idx++) root = (root + value / root) / 2;
+    return root;
+}
+
+/*!
+    \brief Mann-Whitney U test of two samples of durations.
+    \details Ranks both samples together, tied durations get the average of their ranks. The z score uses the
+             normal approximation with the tie correction.
+    \param base Durations of the baseline, sorted ascending.
+    \param base_count Number of baseline durations.
+    \param current Durations of the current run, sorted ascending.
+    \param current_count Number of current durations.
+    \return The z score, positive if the current durations tend to be longer.
+*/
+double myunit_baseline_z(const uint32_t *base, uint32_t base_count, const uint32_t *current, uint32_t current_count)
+{
+    uint32_t total = base_count + current_count;
+    uint32_t i = 0, j = 0, rank = 1;
+    double rank_sum = 0, ties = 0, mean, variance;
+
+    if (!base_count || !current_count) return 0;
+
+    /* Merge the sorted samples, one group of equal durations at a time */
+    while (i < base_count || j < current_count)
+    {
+        uint32_t value = (j >= current_count || (i < base_count && base[i] <= current[j])) ? base[i] : current[j];
+        uint32_t in_base = 0, in_current = 0;
+        double average;
+
+        while (i < base_count && base[i] == value) { i++; in_base++; }
+        while (j < current_count && current[j] == value) { j++; in_current++; }
+
+        average = rank + (in_base + in_current - 1) / 2.0;
+        rank_sum += average * in_current;
+        ties += (double)(in_base + in_current) * (in_base + in_current) * (in_base + in_current) - (in_base + in_current);
+        rank += in_base + in_current;
+    }
+
+    mean = (double)base_count * current_count / 2;
+    variance = (double)base_count * current_count / 12 * ((total + 1) - ties / ((double)total * (total - 1)));
+    if (variance <= 0) return 0;
+
+    return (rank_sum - (double)current_count * (current_count + 1) / 2 - mean) / myunit_baseline_sqrt(variance);
+}
+
+/*!
+    \brief Saves and compares the durations of the repeated test case.
+    \details With the `MYUNIT_BASELINE_SAVE` option, the durations are appended to the baseline as a line
+             `suite name count duration...`, the latest line of a test case of the test suite counts. With the
+             `MYUNIT_BASELINE` option, they are compared to the durations of the test case of the same test suite
+             in the baseline by the Mann-Whitney U test. A
+             `<TCD>` record reports the baseline and current median in microseconds, the change in percent, the
+             z score in hundredths and the verdict `REGRESSION`, `IMPROVED` or `UNCHANGED`. A regression is
+             reported by a failed assertion with the message "REGRESSION". A test case missing in the baseline is
+             not compared, its `<TCD>` record has the verdict `MISSING`, or `TRUNCATED` if the latest lines of the
+             baseline do not fit into `MYUNIT_BASELINE_BUFFER`.
+    \param samples Durations of the test case in microseconds, sorted ascending.
+    \param count Number of durations.
+*/
+void myunit_baseline_check(const uint32_t *samples, uint32_t count)
+{
+    static char buffer[MYUNIT_BASELINE_BUFFER];
+    uint32_t base[MYUNIT_REPEAT_SAMPLES];
+    uint32_t base_count = 0, idx;
+    size_t suite_len = strlen(myunit_testsuite_name), len = strlen(myunit_testcase_name);
+    char *line, *end;
+    bool complete;
+
+    if (myunit_baseline_save_path && suite_len + len + 12 * (count + 2) < sizeof(buffer))
+    {
+        end = buffer;
+        memcpy(end,myunit_testsuite_name,suite_len);
+        end += suite_len;
+        *end++ = ' ';
+        memcpy(end,myunit_testcase_name,len);
+        end += len;
+        *end++ = ' ';
+        end = myunit_format_unsigned(end,count);
+        for (idx = 0; idx < count; idx++)
+        {
+            *end++ = ' ';
+            end = myunit_format_unsigned(end,samples[idx]);
+        }
+        *end++ = '\n';
+        myunit_platform_store(myunit_baseline_save_path,buffer,(size_t)(end - buffer),true);
+    }
+
+    if (!myunit_baseline_path || !count) return;
+    complete = myunit_records_load(myunit_baseline_path,buffer,sizeof(buffer),2);
+
+    for (line = buffer; *line; line = (*end) ? end + 1 : end)
+    {
+        end = strchr(line,'\n');
+        if (!end) end = line + strlen(line);
+        if (!strncmp(line,myunit_testsuite_name,suite_len) && line[suite_len] == ' ' &&
+            !strncmp(line + suite_len + 1,myunit_testcase_name,len) && line[suite_len + 1 + len] == ' ')
+        {
+            char *field = line + suite_len + 1 + len;
+            uint32_t expected = (uint32_t)strtoul(field,&field,10);
+
+            while (base_count < expected && base_count < MYUNIT_REPEAT_SAMPLES && field < end)
+            {
+                base[base_count++] = (uint32_t)strtoul(field,&field,10);
+            }
+            break;
+        }
+    }
+    if (!base_count)
+    {
+        MYUNIT_PRINTF("%s %s %s 0 %u 0 0 %s\n",myunit_testcase_baseline_tag,myunit_testsuite_name,myunit_testcase_name,
+                      (unsigned)samples[count / 2],complete ? "MISSING" : "TRUNCATED");
+        return;
+    }
+
+    {
+        uint32_t base_median = myunit_testcase_median(base,base_count);
+        uint32_t median = samples[count / 2];
+        double z = myunit_baseline_z(base,base_count,samples,count);
+        int32_t change = base_median ? (int32_t)(((int64_t)median - base_median) * 100 / base_median) : 0;
+        const char *verdict = "UNCHANGED";
+
+        if (z >= myunit_regression_z && change > (int32_t)myunit_regression_tolerance) verdict = "REGRESSION";
+        else if (z <= -myunit_regression_z && change < -(int32_t)myunit_regression_tolerance) verdict = "IMPROVED";
+
+        MYUNIT_PRINTF("%s %s %s %u %u %d %d %s\n",myunit_testcase_baseline_tag,myunit_testsuite_name,myunit_testcase_name,
+                      (unsigned)base_median,(unsigned)median,(int)change,(int)(z * 100),verdict);
+
+        if (verdict[0] == 'R')
+        {
+            myunit_testcase_assert_fail_count++;
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"REGRESSION","slower than the baseline");
+            MYUNIT_FAILURE_ACTION();
+        }
+    }
+}
+
+    #define MYUNIT_BASELINE_CHECK(samples,count) myunit_baseline_check(samples,count)
+#else
+    #define MYUNIT_BASELINE_CHECK(samples,count)
+#endif
+
+
+/*!
+    \brief Runs a test case repeatedly and prints the `<TCR>` summary.
+    \details Runs the test case as configured by `MYUNIT_SET_REPEAT`, each time with a different seed. The
+             duration of every run is measured with `myunit_platform_clock`. The median is estimated from a
+             reservoir sample of `MYUNIT_REPEAT_SAMPLES` durations. The summary reports the runs, the failed
+             runs, the minimum, median and maximum duration in microseconds, the verdict and the index and seed
+             of the first failed run (-1 and 0 if all runs passed). The verdict is `STABLE` if all runs
+             passed, `FAILING` if all runs failed and `FLAKY` otherwise. Built with `MYUNIT_BASELINE`, the
+             durations are then saved to and compared with the baseline, see `myunit_baseline_check`.
+    \param testcase A pointer to the function representing the test case to be executed.
+    \param timeout Timeout in milliseconds of each run, 0 disables the watchdog.
+*/
+void myunit_testcase_repeat(void(*testcase)(), uint32_t timeout)
+{
+    uint32_t samples[MYUNIT_REPEAT_SAMPLES];
+    uint32_t runs = 0, failed = 0, min = UINT32_MAX, max = 0;
+    int first_fail = -1;
+    uint32_t first_fail_seed = 0;
+    uint64_t start = myunit_platform_clock();
+    uint64_t duration = (uint64_t)myunit_testsuite_repeat_duration * 1000000u;
+
+    do
+    {
+        int fail_count = myunit_testcase_assert_fail_count;
+        uint64_t begin;
+        uint32_t elapsed;
+
+        myunit_testcase_seed = myunit_seed_mix(myunit_testsuite_seed ^ myunit_seed_mix(runs));
+        begin = myunit_platform_clock();
+        myunit_testcase_run(testcase,timeout);
+        elapsed = (uint32_t)((myunit_platform_clock() - begin) / 1000u);
+
+        if (elapsed < min) min = elapsed;
+        if (elapsed > max) max = elapsed;
+        if (runs < MYUNIT_REPEAT_SAMPLES) samples[runs] = elapsed;
+        else
+        {
+            uint32_t slot = myunit_seed_mix(myunit_testcase_seed) % (runs + 1);
+            if (slot < MYUNIT_REPEAT_SAMPLES) samples[slot] = elapsed;
+        }
+
+        if (myunit_testcase_assert_fail_count != fail_count)
+        {
+            if (!failed++)
+            {
+                first_fail = (int)runs;
+                first_fail_seed = myunit_testcase_seed;
+            }
+        }
+        runs++;
+    }
+    while (!myunit_testsuite_stopped && !(failed && myunit_testsuite_repeat_stop) &&
+           (runs < myunit_testsuite_repeat_count || (myunit_platform_clock() - start) < duration));
+
+    MYUNIT_PRINTF("%s %s %s %u %u %u %u %u %s %d %u\n",myunit_testcase_repeat_tag,myunit_testsuite_name,myunit_testcase_name,
+                  (unsigned)runs,(unsigned)failed,(unsigned)min,
+                  (unsigned)myunit_testcase_median(samples,(runs < MYUNIT_REPEAT_SAMPLES) ? runs : MYUNIT_REPEAT_SAMPLES),
+                  (unsigned)max,(!failed) ? "STABLE" : ((failed == runs) ? "FAILING" : "FLAKY"),
+                  first_fail,(unsigned)first_fail_seed);
+    MYUNIT_BASELINE_CHECK(samples,(runs < MYUNIT_REPEAT_SAMPLES) ? runs : MYUNIT_REPEAT_SAMPLES);
+}
+
+
+#ifdef MYUNIT_HISTORY
+
+#ifndef MYUNIT_HISTORY_BUFFER
+#define MYUNIT_HISTORY_BUFFER 8192 /*!< Bytes of the latest records of the history file which are kept. */
+#endif
+
+#ifndef MYUNIT_HISTORY_SLOWEST
+#define MYUNIT_HISTORY_SLOWEST 5 /*!< Test cases listed as the slowest at the end of the test suite. */
+#endif
+
+/*!
+    \brief Configuration restored before each pass over the test suite.
+*/
+typedef struct {
+    uint32_t timeout;
+    uint32_t max_failed_testcases;
+    uint32_t max_failed_asserts;
+    uint32_t repeat_count;
+    uint32_t repeat_duration;
+    bool repeat_stop;
+    uint32_t seed;
+    void (*setup)(void);
+    void (*teardown)(void);
+    bool isolation;
+} myunit_history_config_t;
+
+/*!
+    \brief One of the slowest test cases.
+*/
+typedef struct {
+    char name[MYUNIT_TESTCASE_NAME_SIZE];   /*!< Name of the test case */
+    uint32_t duration;                      /*!< Duration in microseconds */
+} myunit_history_slowest_t;
+
+char myunit_history[MYUNIT_HISTORY_BUFFER];                             /*!< Records of the history file. */
+const char *myunit_history_path;                                        /*!< History file, `MYUNIT_HISTORY` option */
+const char *myunit_history_suite;                                       /*!< Test suite the records are searched for. */
+int myunit_history_pass;                                                /*!< 0 runs the test cases failed last time, 1 the others. */
+myunit_history_config_t myunit_history_config;                          /*!< Configuration at the start of the first pass. */
+uint64_t myunit_history_start;                                          /*!< `myunit_platform_clock` at the start of the test case. */
+myunit_history_slowest_t myunit_history_slowest[MYUNIT_HISTORY_SLOWEST];/*!< Slowest test cases, slowest first. */
+uint32_t myunit_history_slowest_count;                                  /*!< Entries of the slowest test cases. */
+
+
+/*!
+    \brief Returns the end of the record starting at `line`, excluding the newline.
+*/
+const char *myunit_history_end(const char *line)
+{
+    const char *end = strchr(line,'\n');
+    return end ? end : line + strlen(line);
+}
+
+/*!
+    \brief Searches the records of a test case of the test suite, including the records of its rows `name[i]`.
+    \details Records are lines `suite name status duration build`, the build is the date and time the test suite
+             was compiled. The latest record of a test case counts, even if it was written by another build, the
+             loaded history holds only the latest records.
+    \param line The record to start at, set to the record following the one found.
+    \return The status of the record found, NULL if no further record of the test case follows.
+*/
+const char *myunit_history_find(const char **line, const char *name, size_t len)
+{
+    size_t suite_len = strlen(myunit_history_suite);
+
+    while (**line)
+    {
+        const char *record = *line, *end = myunit_history_end(record);
+        const char *key = record + suite_len + 1;
+
+        *line = (*end) ? end + 1 : end;
+        if (!strncmp(record,myunit_history_suite,suite_len) && record[suite_len] == ' ' && !strncmp(key,name,len))
+        {
+            const char *field = key + len;
+
+            if (*field == '[') field += strcspn(field," \n");
+            if (*field == ' ' && field < end) return field + 1;
+        }
+    }
+    return NULL;
+}
+
+/*!
+    \brief Returns `true` if the test case, or one of its rows, failed the last time it was executed.
+*/
+bool myunit_history_failed(const char *name)
+{
+    const char *line = myunit_history, *status;
+    size_t len = strlen(name);
+
+    while ((status = myunit_history_find(&line,name,len)))
+    {
+        if (!strncmp(status,"FAIL ",5)) return true;
+    }
+    return false;
+}
+
+/*!
+    \brief Returns the duration of the test case, or the sum of its rows, in microseconds the last time it was
+           executed, 0 if unknown.
+*/
+uint32_t myunit_history_duration(const char *name)
+{
+    const char *line = myunit_history, *status;
+    size_t len = strlen(name);
+    uint32_t duration = 0;
+
+    while ((status = myunit_history_find(&line,name,len)))
+    {
+        duration += (uint32_t)strtoul(status + 5,NULL,10);
+    }
+    return duration;
+}
+
+/*!
+    \brief Loads the history file given by the `MYUNIT_HISTORY` option.
+    \details Built with `MYUNIT_HISTORY_FAILED_FIRST`, the test suite runs in two passes if one of its test cases
+             failed last time: the first one executes the test cases which failed last time, the second one the
+             others. The latest record of each test case is kept, see `myunit_records_load`.
+    \param suite Name of the test suite.
+*/
+void myunit_history_load(const char *suite)
+{
+#ifdef MYUNIT_HISTORY_FAILED_FIRST
+    const char *line, *end;
+#endif
+
+    myunit_history_suite = suite;
+    myunit_history_pass = 1;
+    myunit_history_slowest_count = 0;
+    myunit_history[0] = 0;
+    myunit_history_path = myunit_platform_option("MYUNIT_HISTORY");
+    if (!myunit_history_path) return;
+
+    myunit_records_load(myunit_history_path,myunit_history,sizeof(myunit_history),2);
+
+#ifdef MYUNIT_HISTORY_FAILED_FIRST
+    for (line = myunit_history; *line && myunit_history_pass; line = (*end) ? end + 1 : end)
+    {
+        size_t suite_len = strlen(suite);
+
+        end = myunit_history_end(line);
+        if (!strncmp(line,suite,suite_len) && line[suite_len] == ' ')
+        {
+            const char *status = line + suite_len + 1;
+
+            status += strcspn(status," \n");
+            if (!strncmp(status," FAIL ",6)) myunit_history_pass = 0;
+        }
+    }
+#endif
+}
+
+/*!
+    \brief Starts a pass over the test suite.
+    \details Saves the configuration at the start of the first pass and restores it at the start of the second.
+             The second pass starts with the snapshot dropped and a fail-fast limit of its own, which only counts
+             the failures of the second pass, so a first pass stopped by fail-fast does not skip it.
+*/
+void myunit_history_pass_begin(void)
+{
+    myunit_history_config_t *config = &myunit_history_config;
+
+    if (myunit_history_pass == 0 || !myunit_history_path)
+    {
+        config->timeout = myunit_testsuite_timeout;
+        config->max_failed_testcases = myunit_testsuite_max_failed_testcases;
+        config->max_failed_asserts = myunit_testsuite_max_failed_asserts;
+        config->repeat_count = myunit_testsuite_repeat_count;
+        config->repeat_duration = myunit_testsuite_repeat_duration;
+        config->repeat_stop = myunit_testsuite_repeat_stop;
+        config->seed = myunit_testsuite_seed;
+        config->setup = myunit_testcase_setup;
+        config->teardown = myunit_testcase_teardown;
+        config->isolation = myunit_testsuite_isolation;
+        return;
+    }
+    myunit_testsuite_timeout = config->timeout;
+    myunit_testsuite_max_failed_testcases = config->max_failed_testcases;
+    myunit_testsuite_max_failed_asserts = config->max_failed_asserts;
+    myunit_testsuite_repeat_count = config->repeat_count;
+    myunit_testsuite_repeat_duration = config->repeat_duration;
+    myunit_testsuite_repeat_stop = config->repeat_stop;
+    myunit_testsuite_seed = config->seed;
+    myunit_testcase_setup = config->setup;
+    myunit_testcase_teardown = config->teardown;
+    myunit_testsuite_isolation = config->isolation;
+    myunit_testsuite_fail_fast_testcases = myunit_testcase_fail_count;
+    myunit_testsuite_fail_fast_asserts = myunit_testsuite_assert_fail_count;
+    myunit_testsuite_stopped = false;
+    MYUNIT_SNAPSHOT_DROP();
+}
+
+/*!
+    \brief Ends a pass over the test suite.
+    \return `true` if the second pass follows.
+*/
+bool myunit_history_pass_end(void)
+{
+    if (myunit_history_pass) return false;
+    myunit_history_pass = 1;
+    return true;
+}
+
+/*!
+    \brief Records the result and the duration of the current test case.
+    \details Appends a record to the history file and keeps the test case if it is one of the slowest.
+*/
+void myunit_history_record(void)
+{
+    uint32_t duration = (uint32_t)((myunit_platform_clock() - myunit_history_start) / 1000u);
+    size_t len = strlen(myunit_testcase_name);
+    uint32_t idx;
+
+    if (myunit_history_path)
+    {
+        char record[MYUNIT_TESTCASE_NAME_SIZE + 96];
+        const char *build = __DATE__ " " __TIME__;
+        size_t suite_len = strlen(myunit_history_suite);
+        char *end = record;
+
+        if (suite_len + len + strlen(build) + 20 < sizeof(record))
+        {
+            memcpy(end,myunit_history_suite,suite_len);
+            end += suite_len;
+            *end++ = ' ';
+            memcpy(end,myunit_testcase_name,len);
+            end += len;
+            memcpy(end,myunit_testcase_assert_fail_count ? " FAIL " : " PASS ",6);
+            end = myunit_format_unsigned(end + 6,duration);
+            *end++ = ' ';
+            memcpy(end,build,strlen(build));
+            end += strlen(build);
+            *end++ = '\n';
+            myunit_platform_store(myunit_history_path,record,(size_t)(end - record),true);
+        }
+    }
+
+    for (idx = myunit_history_slowest_count; idx > 0 && myunit_history_slowest[idx - 1].duration < duration; idx--)
+    {
+        if (idx < MYUNIT_HISTORY_SLOWEST) myunit_history_slowest[idx] = myunit_history_slowest[idx - 1];
+    }
+    if (idx < MYUNIT_HISTORY_SLOWEST)
+    {
+        if (len >= MYUNIT_TESTCASE_NAME_SIZE) len = MYUNIT_TESTCASE_NAME_SIZE - 1;
+        memcpy(myunit_history_slowest[idx].name,myunit_testcase_name,len);
+        myunit_history_slowest[idx].name[len] = 0;
+        myunit_history_slowest[idx].duration = duration;
+        if (myunit_history_slowest_count < MYUNIT_HISTORY_SLOWEST) myunit_history_slowest_count++;
+    }
+}
+
+/*!
+    \brief Prints the slowest test cases, one `<TSL>` record each with the rank, name and duration in microseconds.
+*/
+void myunit_history_report(void)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < myunit_history_slowest_count; idx++)
+    {
+        MYUNIT_PRINTF("%s %s %u %s %u\n",myunit_testsuite_slowest_tag,myunit_testsuite_name,(unsigned)(idx + 1),
+                      myunit_history_slowest[idx].name,(unsigned)myunit_history_slowest[idx].duration);
+    }
+}
+
+/*!
+    \brief Runs the test suite body in passes, if built with `MYUNIT_HISTORY_FAILED_FIRST`.
+    \details The second pass jumps back to the start of the body following `MYUNIT_TESTSUITE_BEGIN`, so the whole
+             body runs twice: the statements between the test cases run once per pass, e.g. hardware
+             initialization, `MYUNIT_SET_*` calls or building the state of a snapshot. They must build the same
+             state again, the snapshot is dropped at the start of the second pass. `myunit_testsuite_setup` runs
+             once. Without `MYUNIT_HISTORY_FAILED_FIRST`, the body runs once in the order written.
+*/
+    #define MYUNIT_HISTORY_LOAD(suite)      myunit_history_load(suite)
+#ifdef MYUNIT_HISTORY_FAILED_FIRST
+    #define MYUNIT_HISTORY_PASS_START()     myunit_history_pass: myunit_history_pass_begin()
+    #define MYUNIT_HISTORY_PASS_END()       do{if(myunit_history_pass_end()) goto myunit_history_pass; myunit_history_report();}while(0)
+#else
+    #define MYUNIT_HISTORY_PASS_START()
+    #define MYUNIT_HISTORY_PASS_END()       myunit_history_report()
+#endif
+    #define MYUNIT_HISTORY_START()          myunit_history_start = myunit_platform_clock()
+    #define MYUNIT_HISTORY_RECORD()         myunit_history_record()
+#else
+    #define MYUNIT_HISTORY_LOAD(suite)
+    #define MYUNIT_HISTORY_PASS_START()
+    #define MYUNIT_HISTORY_PASS_END()
+    #define MYUNIT_HISTORY_START()
+    #define MYUNIT_HISTORY_RECORD()
+#endif
+
+
+#ifdef MYUNIT_COVERAGE
+
+extern myunit_cover_t __start_myunit_cover[] __attribute__((weak));
+extern myunit_cover_t __stop_myunit_cover[] __attribute__((weak));
+
+/*!
+    \brief Reports the coverage sites of `MYUNIT_COVER`.
+    \details Prints a `<CVU>` record with the file and line of every site which was never reached, followed
+             by a `<CVS>` record with the number of sites reached and the number of sites in total.
+*/
+void myunit_cover_report(void)
+{
+    myunit_cover_t *site;
+    unsigned reached = 0, total = 0;
+
+    for (site = __start_myunit_cover; site < __stop_myunit_cover; site++)
+    {
+        total++;
+        if (site->reached)
+        {
+            reached++;
+            continue;
+        }
+        MYUNIT_PRINTF("%s %s \"%s\" %u\n",myunit_cover_unreached_tag,myunit_testsuite_name,site->file,(unsigned)site->line);
+    }
+    MYUNIT_PRINTF("%s %s %u %u\n",myunit_cover_summary_tag,myunit_testsuite_name,reached,total);
+}
+
+    #define MYUNIT_COVER_REPORT() myunit_cover_report()
+#else
+    #define MYUNIT_COVER_REPORT()
+#endif
+
+
+#ifdef MYUNIT_IMPACT
+
+#ifndef MYUNIT_IMPACT_BUFFER
+#define MYUNIT_IMPACT_BUFFER 16384 /*!< Bytes of the latest records of the impact map which are kept. */
+#endif
+
+#ifndef MYUNIT_IMPACT_FILES
+#define MYUNIT_IMPACT_FILES 2048 /*!< Bytes of the source files of one test case in the impact map. */
+#endif
+
+char myunit_impact_map[MYUNIT_IMPACT_BUFFER];       /*!< Records of the impact map, `MYUNIT_IMPACT` option */
+char myunit_impact_record_buffer[MYUNIT_TESTCASE_NAME_SIZE + MYUNIT_IMPACT_FILES + 64]; /*!< Record being written */
+const char *myunit_impact_record_path;              /*!< Impact map to write, `MYUNIT_IMPACT_RECORD` option */
+const char *myunit_impact_changed;                  /*!< Changed source files, `MYUNIT_CHANGED` option */
+const char *myunit_impact_suite;                    /*!< Test suite the records are searched for. */
+
+
+/*!
+    \brief Applies the options of the change-impact test selection.
+    \details With `MYUNIT_IMPACT_RECORD`, the record `suite name file...` of every executed test case with the
+             source files of the functions it executed is appended to the impact map. The latest record of a test
+             case counts, so the map can be recorded by several runs, e.g. of the test cases run by CTest. With
+             `MYUNIT_IMPACT` and `MYUNIT_CHANGED`, only the test cases affected by the changed files are executed,
+             see `myunit_impact_selected`. If the latest records do not fit into `MYUNIT_IMPACT_BUFFER`, all test
+             cases are executed.
+    \param suite Name of the test suite.
+*/
+void myunit_impact_load(const char *suite)
+{
+    const char *path;
+
+    myunit_impact_suite = suite;
+    myunit_impact_map[0] = 0;
+    myunit_impact_record_path = myunit_platform_option("MYUNIT_IMPACT_RECORD");
+
+    myunit_impact_changed = myunit_platform_option("MYUNIT_CHANGED");
+    path = myunit_platform_option("MYUNIT_IMPACT");
+    if (!path || !myunit_impact_changed || !myunit_records_load(path,myunit_impact_map,sizeof(myunit_impact_map),2))
+    {
+        myunit_impact_changed = NULL;
+    }
+}
+
+/*!
+    \brief Returns `true` if a recorded source file is one of the changed files.
+    \details A changed file matches if it equals the recorded path or ends it after a `/`, so paths relative
+             to the repository, e.g. from `git diff --name-only`, match the absolute paths of the map.
+*/
+bool myunit_impact_changed_file(const char *file, size_t len)
+{
+    const char *changed = myunit_impact_changed;
+
+    while (*changed)
+    {
+        size_t changed_len = strcspn(changed,", \n");
+
+        if (changed_len && changed_len <= len && !strncmp(file + len - changed_len,changed,changed_len) &&
+            (changed_len == len || file[len - changed_len - 1] == '/'))
+        {
+            return true;
+        }
+        changed += changed_len;
+        changed += strspn(changed,", \n");
+    }
+    return false;
+}
+
+/*!
+    \brief Returns `true` if a test case is affected by the changed files.
+    \details Test cases without a record in the impact map, test cases whose functions could not be resolved
+             and test cases whose record is incomplete are always affected. Without the `MYUNIT_IMPACT` and `MYUNIT_CHANGED` options, all test
+             cases are affected.
+*/
+bool myunit_impact_selected(const char *name)
+{
+    size_t suite_len, name_len = strlen(name);
+    const char *line, *end, *files = NULL;
+
+    if (!myunit_impact_changed) return true;
+
+    suite_len = strlen(myunit_impact_suite);
+    for (line = myunit_impact_map; *line; line = (*end) ? end + 1 : end)
+    {
+        end = strchr(line,'\n');
+        if (!end) end = line + strlen(line);
+        if (!strncmp(line,myunit_impact_suite,suite_len) && line[suite_len] == ' ' &&
+            !strncmp(line + suite_len + 1,name,name_len) && line[suite_len + 1 + name_len] == ' ')
+        {
+            files = line + suite_len + 1 + name_len + 1;
+        }
+    }
+    if (!files || !strchr(files,'\n')) return true;
+
+    while (*files && *files != '\n')
+    {
+        size_t len = strcspn(files," \n");
+
+        if ((len == 1 && *files == '*') || myunit_impact_changed_file(files,len)) return true;
+        files += len;
+        if (*files == ' ') files++;
+    }
+    return false;
+}
+
+/*!
+    \brief Appends the record of the current test case to the impact map.
+*/
+void myunit_impact_record(void)
+{
+    char *record = myunit_impact_record_buffer;
+    size_t suite_len = strlen(myunit_impact_suite), name_len = strlen(myunit_testcase_name), len;
+
+    if (suite_len + name_len + MYUNIT_IMPACT_FILES + 3 > sizeof(myunit_impact_record_buffer))
+    {
+        myunit_platform_trace_end(record,MYUNIT_IMPACT_FILES);
+        return;
+    }
+    memcpy(record,myunit_impact_suite,suite_len);
+    record[suite_len] = ' ';
+    memcpy(record + suite_len + 1,myunit_testcase_name,name_len);
+    len = suite_len + 1 + name_len;
+    record[len++] = ' ';
+    len += myunit_platform_trace_end(record + len,MYUNIT_IMPACT_FILES);
+    record[len++] = '\n';
+    myunit_platform_store(myunit_impact_record_path,record,len,true);
+}
+
+    #define MYUNIT_IMPACT_LOAD(suite)   myunit_impact_load(suite)
+    #define MYUNIT_IMPACT_START()       do{if(myunit_impact_record_path) myunit_platform_trace_begin();}while(0)
+    #define MYUNIT_IMPACT_RECORD()      do{if(myunit_impact_record_path) myunit_impact_record();}while(0)
+#else
+    #define MYUNIT_IMPACT_LOAD(suite)
+    #define MYUNIT_IMPACT_START()
+    #define MYUNIT_IMPACT_RECORD()
+#endif
+
+
+/*!
+    \brief Checks a test case name against the `MYUNIT_FILTER` option.
+    \return `true` if the test case is to be executed. The rows `name[i]` of a parameterized test case are
+            selected by `name`. Built with `MYUNIT_HISTORY_FAILED_FIRST`, only the test cases of the current
+            pass are selected, see `myunit_history_load`. Built with `MYUNIT_IMPACT`, only the test cases
+            affected by the changed files are selected, see `myunit_impact_selected`. The others are reported by
+            a `<TCU>` record, so a runner of single test cases can tell them from test cases which did not run.
+*/
+bool myunit_testcase_selected(const char *name)
+{
+    size_t len;
+
+    if (myunit_testsuite_filter)
+    {
+        len = strlen(myunit_testsuite_filter);
+        if (strncmp(name,myunit_testsuite_filter,len) || (name[len] != 0 && name[len] != '[')) return false;
+    }
+#ifdef MYUNIT_HISTORY_FAILED_FIRST
+    if (myunit_history_failed(name) != (myunit_history_pass == 0)) return false;
+#endif
+#ifdef MYUNIT_IMPACT
+    if (!myunit_impact_selected(name))
+    {
+        MYUNIT_PRINTF("%s %s %s\n",myunit_testcase_unaffected_tag,myunit_testsuite_name,name);
+        return false;
+    }
+#endif
+    return true;
+}
+
+
+/*!
+    \brief Starts the bookkeeping of a test case.
+    \details Resets the test case counters and the peak arena usage, if built with `MYUNIT_ARENA`, and prints the
+             `<TCB>` record.
+    \param name The name of the test case, used for logging purposes.
+*/
+void myunit_testcase_begin(char *name)
+{
+    myunit_testcase_assert_fail_count  = myunit_testcase_assert_success_count = 0;
+    myunit_testcase_last_line = 0;
+    myunit_testcase_name = name;
+    MYUNIT_ARENA_BEGIN();
+    MYUNIT_PRINTF("%s %s %s\n",myunit_testcase_begin_tag,myunit_testsuite_name,name);
+    MYUNIT_HISTORY_START();
+    MYUNIT_IMPACT_START();
+}
+
+
+/*!
+    \brief Ends the bookkeeping of the current test case.
+    \details Prints the `<TCM>` record if the test case used the arena of `MYUNIT_ARENA` and the `<TCE>` record,
+             adds the test case counters to the test suite and checks the fail-fast limits if the test case failed.
+*/
+void myunit_testcase_end(void)
+{
+    MYUNIT_ASSERT_SITES_REPORT();
+    MYUNIT_ARENA_REPORT();
+    MYUNIT_PRINTF("%s %s %s %d %d\n",myunit_testcase_end_tag,myunit_testsuite_name,myunit_testcase_name,myunit_testcase_assert_fail_count,myunit_testcase_assert_success_count);
+    myunit_testsuite_assert_fail_count+=myunit_testcase_assert_fail_count;
+    myunit_testsuite_assert_success_count+=myunit_testcase_assert_success_count;
+    (myunit_testcase_assert_fail_count)?(myunit_testcase_fail_count++):(myunit_testcase_success_count++);
+    MYUNIT_IMPACT_RECORD();
+    MYUNIT_HISTORY_RECORD();
+    if (myunit_testcase_assert_fail_count) myunit_testsuite_fail_fast();
+}
+
+
+/*!
+    \brief Executes a test case within the current test suite.
+    \details This function runs a specified test case and prints relevant information about the test case's execution,
+             including the test case's start and end. It updates assertion and test case counters based on the results of the test case.
+             If `timeout` is not zero, the test case is guarded by the platform watchdog. A test case which does not return
+             in time is aborted and reported by a failed assertion with the message "TIMEOUT" on the line of the last
+             passed assertion, then execution continues with the next test case.
+             A test case aborted by `MYUNIT_REQUIRE` or a fail-fast limit ends at the failed assertion. After a
+             fail-fast limit is reached, the test case is not executed and reported as skipped instead.
+             With repetitions set by `MYUNIT_SET_REPEAT`, the test case is run repeatedly, the counters in the
+             `<TCE>` record include all runs. Test cases not selected by the `MYUNIT_FILTER` option are
+             ignored without any output.
+    \param name The name of the test case, used for logging purposes.
+    \param testcase A pointer to the function representing the test case to be executed.
+    \param timeout Timeout in milliseconds, 0 disables the watchdog.
+    \note The function updates both the test case and test suite assertion success and failure counts.
+    \note The printed output includes:
+          - The test case begin tag (`myunit_testcase_begin_tag`)
+          - The test case end tag (`myunit_testcase_end_tag`)
+          - The test suite name (`myunit_testsuite_name`)
+          - The test case name (`name`)
+          - The number of failed assertions in the test case (`myunit_testcase_assert_fail_count`)
+*/
+void myunit_exec_testcase_timeout(char *name, void(*testcase)(), uint32_t timeout)
+{
+    if (!myunit_testcase_selected(name)) return;
+    if (myunit_testsuite_stopped)
+    {
+        myunit_testcase_skip_count++;
+        MYUNIT_PRINTF("%s %s %s\n",myunit_testcase_skipped_tag,myunit_testsuite_name,name);
+        return;
+    }
+    myunit_testcase_begin(name);
+    if (myunit_testsuite_repeat_count > 1 || myunit_testsuite_repeat_duration)
+    {
+        myunit_testcase_repeat(testcase,timeout);
+    }
+    else
+    {
+        myunit_testcase_seed = myunit_testsuite_seed;
+        myunit_testcase_run(testcase,timeout);
+    }
+    myunit_testcase_end();
+}
+
+
+/*!
+    \brief Executes a test case with the test suite default timeout.
+    \param name The name of the test case, used for logging purposes.
+    \param testcase A pointer to the function representing the test case to be executed.
+*/
+void myunit_exec_testcase(char *name, void(*testcase)())
+{
+    myunit_exec_testcase_timeout(name,testcase,myunit_testsuite_timeout);
+}
+
+
+const void *myunit_testcase_param;                              /*!< Row of the running parameterized test case. */
+char myunit_testcase_row_name[MYUNIT_TESTCASE_NAME_SIZE];       /*!< Name of the running parameterized test case row. */
+
+/*!
+    \brief Defines a parameterized test case driven by a constant table.
+    \details The test case is executed once for every row of `table`. The body following the macro receives
+             a pointer `param` to the current row. Rows are accessed in place, so a `const` table stays in
+             read-only memory and no row is copied to RAM.
+    \param name The name of the test case.
+    \param type The type of a table row.
+    \param table The table, an array of `type` whose size is known at this point.
 */
-#define MYUNIT_CHECKPOINTS_SIZE() ((sizeof(myunit_checkpoints)/sizeof(*myunit_checkpoints))<<3)
+#define MYUNIT_TESTCASE_P(name,type,table)                                          \
+    void myunit_testcase_p_##name(const type *param);                               \
+    MYUNIT_TESTCASE(name) { myunit_testcase_p_##name((const type*)myunit_testcase_param); } \
+    const type *const myunit_testcase_table_##name = (table);                       \
+    const size_t myunit_testcase_rows_##name = sizeof(table)/sizeof(*(table));      \
+    void myunit_testcase_p_##name(const type *param)
 
 /*!
-    \brief Initializes all checkpoints
-    \details This macro initializes all elements in the `myunit_checkpoints` array by clearing each checkpoint.
-             It iterates through the array and resets every index to 0.
+    \brief Executes a parameterized test case for every row of its table.
+    \details Each row is reported as a test case of its own, named after the test case and the row index,
+             e.g. `name[17]`, and counted as a passed or failed test case of its own.
+    \param name The name of the test case, as used in `MYUNIT_TESTCASE_P`.
 */
-#define MYUNIT_CHECKPOINS_INIT()   memset(myunit_checkpoints,0x00,sizeof(myunit_checkpoints))
+#define MYUNIT_EXEC_TESTCASE_P(name)                                                \
+        myunit_exec_testcase_p(#name, myunit_testcase_##name, myunit_testcase_table_##name, \
+            sizeof(*myunit_testcase_table_##name), myunit_testcase_rows_##name)
 
 
 /*!
-    \brief Handles printing and assertion logging based on verbosity level
-    \details This block defines macros for printing output and logging assertions based on the verbosity level.
-             When the verbosity is set to a non-silent mode, the macros for printing (`MYUNIT_PRINTF`) and
-             assertion logging (`MYUNIT_ASSERT_PRINTF`) are enabled. Additionally, various tags are defined for
-             marking the start and end of test cases and test suites.
-             - For verbosity levels 1, 2, and 3, different levels of detail are printed for assertions.
-             - If the verbosity level is set to `MYUNIT_SILENT`, no output is generated.
-*/
-/*!
-    \def MYUNIT_PRINTF
-    \brief Macro for printing output during unit tests
-    \details When verbosity is enabled, this macro prints formatted output using `myunit_platform_printf`.
-    \param ... Variable arguments passed to the underlying platform's print function.
+    \brief Executes a test case once for every row of a table.
+    \param name The name of the test case, the row index is appended.
+    \param testcase The test case, which reads its row from `myunit_testcase_param`.
+    \param table The first row of the table.
+    \param row_size The size of a row in bytes.
+    \param rows The number of rows.
 */
-#if (MYUNIT_VERBOSITY_LEVEL !=  MYUNIT_SILENT)
+void myunit_exec_testcase_p(const char *name, void(*testcase)(), const void *table, size_t row_size, size_t rows)
+{
+    size_t row;
+
+    for (row = 0; row < rows; row++)
+    {
+        char digits[12];
+        size_t len = 0;
+        size_t ndigits = 0;
+        size_t value = row;
+
+        do { digits[ndigits++] = (char)('0' + value % 10); value /= 10; } while (value && ndigits < sizeof(digits));
+
+        // Leaves room for "[", the digits, "]" and the terminator.
+        while (name[len] && len < MYUNIT_TESTCASE_NAME_SIZE - ndigits - 3)
+        {
+            myunit_testcase_row_name[len] = name[len];
+            len++;
+        }
+        myunit_testcase_row_name[len++] = '[';
+        while (ndigits) myunit_testcase_row_name[len++] = digits[--ndigits];
+        myunit_testcase_row_name[len++] = ']';
+        myunit_testcase_row_name[len] = '\0';
+
+        myunit_testcase_param = (const uint8_t*)table + row * row_size;
+        myunit_exec_testcase(myunit_testcase_row_name,testcase);
+    }
 
-    #define MYUNIT_PRINTF(...) myunit_platform_printf(__VA_ARGS__)
+    myunit_testcase_param = NULL;
+}
 
-    #define myunit_testcase_begin_tag       "<TCB>" /*!< Tag indicating the start of a test case */
-    #define myunit_testcase_failure_tag     "<TCF>" /*!< Tag indicating a test case failed */
-    #define myunit_testcase_passed_tag      "<TCP>" /*!< Tag indicating a test case failed */
-    #define myunit_testcase_end_tag         "<TCE>" /*!< Tag indicating the end of a test case */
-    #define myunit_testsuite_begin_tag      "<TSB>" /*!< Tag indicating the start of a test suite */
-    #define myunit_testsuite_end_tag        "<TSE>" /*!< Tag indicating the end of a test suite */
-    #define myunit_sequence_begin_tag       "<SQB>" /*!< Tag indicating the start of a test sequence */
-    #define myunit_sequence_end_tag         "<SQE>" /*!< Tag indicating the end of a test sequence */
 
 
-    #if ( MYUNIT_VERBOSITY_LEVEL == 1 )
-        #define  MYUNIT_ASSERT_PRINTF(result,message,test)   \
-            MYUNIT_PRINTF("%s %s %s %d\n",result,myunit_testsuite_name,myunit_testcase_name,__LINE__)
-    #elif ( MYUNIT_VERBOSITY_LEVEL == 2 )
-        #define  MYUNIT_ASSERT_PRINTF(result,message,test)   \
-            MYUNIT_PRINTF("%s %s %s %d \"%s\"\n",result,myunit_testsuite_name,myunit_testcase_name,__LINE__,message)
-    #elif ( MYUNIT_VERBOSITY_LEVEL == 3 )
-        #define  MYUNIT_ASSERT_PRINTF(result,message,test)   \
-            MYUNIT_PRINTF("%s %s %s %d \"%s\" \"%s\"\n",result,myunit_testsuite_name,myunit_testcase_name,__LINE__,message, #test)
-    #else
-        #error "MYUNIT : Invalid verbose mode"
-    #endif
 
-#else
-    #define MYUNIT_PRINTF(...)    /*!< No-op macro when verbosity is disabled */
-    #define MYUNIT_ASSERT_PRINTF(...)    /*!< No-op macro when verbosity is disabled */
+/*!
+    \brief Inventory of the test cases.
+    \details With `MYUNIT_INVENTORY` defined, every `MYUNIT_TESTCASE` and every assertion adds a constant
+             record to the linker section `myunit_inventory`. The records are NUL-terminated strings
+             `TC <name> <line> <file>` for test cases and `AS <line> <file>` for assertions, so a host tool can
+             read the inventory without executing the binary, e.g. `readelf -p myunit_inventory <binary>`.
+             An assertion belongs to the test case defined last before it in the same file.
+    \note Requires a GCC compatible compiler and a linker providing `__start_` and `__stop_` symbols of
+          sections, as GNU ld and lld on ELF targets do.
+*/
+#if defined(MYUNIT_INVENTORY)
+
+    #define MYUNIT_STRINGIFY_(x) #x
+    #define MYUNIT_STRINGIFY(x) MYUNIT_STRINGIFY_(x)
+    #define MYUNIT_INVENTORY_SECTION __attribute__((section("myunit_inventory"),used))
+    #define myunit_testcase_inventory_tag "<TCI>" /*!< Tag listing a test case of the inventory, printed regardless of the verbosity */
+
+    #define MYUNIT_INVENTORY_TESTCASE(name) \
+        static const char myunit_inventory_##name[] MYUNIT_INVENTORY_SECTION = "TC " #name " " MYUNIT_STRINGIFY(__LINE__) " " __FILE__;
+    #define MYUNIT_INVENTORY_SITE() \
+        static const char myunit_inventory_site[] MYUNIT_INVENTORY_SECTION = "AS " MYUNIT_STRINGIFY(__LINE__) " " __FILE__
+
+#ifndef MYUNIT_INVENTORY_BATCH
+#define MYUNIT_INVENTORY_BATCH 32 /*!< Test cases sorted at a time when the inventory is printed. */
 #endif
 
+extern const char __start_myunit_inventory[] __attribute__((weak));
+extern const char __stop_myunit_inventory[] __attribute__((weak));
 
 /*!
-    \brief Defines a test suite and its execution entry point.
-    \details This macro creates a test suite by defining a function that will execute the test cases
-             in the suite. It also sets up the `main` function to run the test suite, returning
-             `EXIT_SUCCESS` if all tests pass and `EXIT_FAILURE` if any test fails.
-    \param name The name of the test suite, which is used to generate the function names and variables associated with the suite.
-    \note The macro generates a function `name##_exec` where the test suite's logic is implemented.
+    \brief Returns the first record, skipping the padding before it.
 */
-#define MYUNIT_TESTSUITE(name)                                              \
-    static const char *const_myunit_testsuite_name = #name;                 \
-    int name##_exec();                                                      \
-    int main() { return (name##_exec())?EXIT_FAILURE:EXIT_SUCCESS; }        \
-    int name##_exec()
+const char *myunit_inventory_first(void)
+{
+    const char *record = __start_myunit_inventory;
+
+    while (record < __stop_myunit_inventory && !*record) record++;
+    return record;
+}
 
 /*!
-    \brief Marks the beginning of a test suite.
-    \details This macro initializes the platform and test suite setup functions, assigns the test suite name, and
-             resets various counters for assertions and test cases. It also prints a message indicating the start
-             of the test suite, including the file name, date, and time of the test suite execution.
-    \note The printed output includes:
-          - Test suite begin tag (`myunit_testsuite_begin_tag`)
-          - Test suite name (`myunit_testsuite_name`)
-          - The current file name (`__FILE__`)
-          - The current date (`__DATE__`)
-          - The current time (`__TIME__`)
+    \brief Returns the record following `record`, skipping the padding between records.
 */
-#define MYUNIT_TESTSUITE_BEGIN()                                                        \
-    {                                                                                   \
-        myunit_platform_init();                                                         \
-        myunit_testsuite_setup();                                                       \
-        myunit_testsuite_name = (char*)const_myunit_testsuite_name;                     \
-        myunit_testsuite_assert_fail_count = 0;                                         \
-        myunit_testsuite_assert_success_count = 0;                                      \
-        myunit_testcase_success_count = 0;                                              \
-        myunit_testcase_fail_count = 0;                                                 \
-        MYUNIT_PRINTF("%s %s \"%s\" \"%s\" \"%s\"\n",                                   \
-        myunit_testsuite_begin_tag,myunit_testsuite_name,__FILE__,__DATE__,__TIME__);
+const char *myunit_inventory_next(const char *record)
+{
+    record += strlen(record);
+    while (record < __stop_myunit_inventory && !*record) record++;
+    return record;
+}
 
 /*!
-    \brief Marks the end of a test suite and prints the summary.
-    \details This macro concludes the execution of a test suite by printing the results, including the number of failed
-             and successful test cases and assertions. It then calls the teardown function for the test suite and
-             deinitializes the platform. The macro finally returns the number of failed test cases as the function result.
-    \note The printed output includes:
-          - Test suite end tag (`myunit_testsuite_end_tag`)
-          - Test suite name (`myunit_testsuite_name`)
-          - Number of failed test cases (`myunit_testcase_fail_count`)
-          - Number of failed assertions (`myunit_testsuite_assert_fail_count`)
-          - Number of successful test cases (`myunit_testcase_success_count`)
-          - Number of successful assertions (`myunit_testsuite_assert_success_count`)
+    \brief Returns the line of a record and sets `file` to its file.
+    \param name Set to the name of a test case record, may be NULL.
 */
-#define MYUNIT_TESTSUITE_END()                          \
-        MYUNIT_PRINTF("%s %s %d %d %d %d\n",            \
-            myunit_testsuite_end_tag,                   \
-            myunit_testsuite_name,                      \
-            myunit_testcase_fail_count,                 \
-            myunit_testsuite_assert_fail_count,         \
-            myunit_testcase_success_count,              \
-            myunit_testsuite_assert_success_count);     \
-        myunit_testsuite_teardown();                    \
-        myunit_platform_deinit();                       \
-        return (myunit_testcase_fail_count);            \
-    }
+int myunit_inventory_parse(const char *record, const char **name, const char **file)
+{
+    char *end;
+    long line;
+
+    record += 3;
+    if (name) *name = record;
+    if (record[-3] == 'T') record += strcspn(record," ");
+    line = strtol(record,&end,10);
+    *file = end + 1;
+    return (int)line;
+}
 
 /*!
-    \brief Defines a test case within a test suite.
-    \details This macro creates a function for the specified test case. Each test case is implemented as a function
-             with the name `myunit_testcase_##name`, where `name` is the provided name of the test case.
-    \param name The name of the test case, which will be used to generate the function name.
-    \note The actual implementation of the test case should be placed inside the generated function.
+    \brief Compares two records by file and line, a test case record sorts before an assertion on its line.
 */
-#define MYUNIT_TESTCASE(name)  void myunit_testcase_##name(void)
-
+int myunit_inventory_compare(const char *record_a, const char *record_b)
+{
+    const char *file_a, *file_b;
+    int line_a = myunit_inventory_parse(record_a,NULL,&file_a);
+    int line_b = myunit_inventory_parse(record_b,NULL,&file_b);
+    int order = strcmp(file_a,file_b);
+
+    if (order) return order;
+    if (line_a != line_b) return (line_a < line_b) ? -1 : 1;
+    return (record_b[0] == 'T') - (record_a[0] == 'T');
+}
 
 /*!
-    \brief Executes a specific test case within a test suite.
-    \details This macro calls the `myunit_exec_testcase` function to execute a test case, passing the function pointer
-             to the test case and its name as a string for logging purposes.
-    \param name The name of the test case to be executed. This should correspond to the name used in `MYUNIT_TESTCASE`.
+    \brief Returns the number of sorted test case records which do not sort after `record`.
 */
+size_t myunit_inventory_find(const char **testcases, size_t count, const char *record)
+{
+    size_t low = 0, high = count;
 
-#define MYUNIT_EXEC_TESTCASE(name) \
-        myunit_exec_testcase(#name, myunit_testcase_##name)
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
 
+        if (myunit_inventory_compare(testcases[mid],record) <= 0) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
 
 /*!
-    \brief Executes a test case within the current test suite.
-    \details This function runs a specified test case and prints relevant information about the test case's execution,
-             including the test case's start and end. It updates assertion and test case counters based on the results of the test case.
-    \param testcase A pointer to the function representing the test case to be executed.
-    \param name The name of the test case, used for logging purposes.
-    \note The function updates both the test case and test suite assertion success and failure counts.
-    \note The printed output includes:
-          - The test case begin tag (`myunit_testcase_begin_tag`)
-          - The test case end tag (`myunit_testcase_end_tag`)
-          - The test suite name (`myunit_testsuite_name`)
-          - The test case name (`name`)
-          - The number of failed assertions in the test case (`myunit_testcase_assert_fail_count`)
+    \brief Prints the `<TCI>` record of a test case.
 */
-void myunit_exec_testcase(char *name, void(*testcase)())
+void myunit_inventory_print_testcase(const char *suite, const char *testcase, uint32_t asserts)
 {
-    myunit_testcase_assert_fail_count  = myunit_testcase_assert_success_count = 0;
-    myunit_testcase_name = name;
-    MYUNIT_PRINTF("%s %s %s\n",myunit_testcase_begin_tag,myunit_testsuite_name,name);
-    testcase();
-    MYUNIT_PRINTF("%s %s %s %d %d\n",myunit_testcase_end_tag,myunit_testsuite_name,name,myunit_testcase_assert_fail_count,myunit_testcase_assert_success_count);
-    myunit_testsuite_assert_fail_count+=myunit_testcase_assert_fail_count;
-    myunit_testsuite_assert_success_count+=myunit_testcase_assert_success_count;
-    (myunit_testcase_assert_fail_count)?(myunit_testcase_fail_count++):(myunit_testcase_success_count++);
+    char name[MYUNIT_TESTCASE_NAME_SIZE];
+    const char *start, *file;
+    int line = myunit_inventory_parse(testcase,&start,&file);
+    size_t len = strcspn(start," ");
+
+    if (len >= sizeof(name)) len = sizeof(name) - 1;
+    memcpy(name,start,len);
+    name[len] = 0;
+#ifdef MYUNIT_HISTORY
+    myunit_printf("%s %s %s \"%s\" %d %u %u\n",myunit_testcase_inventory_tag,suite,name,file,line,
+                           (unsigned)asserts,(unsigned)myunit_history_duration(name));
+#else
+    myunit_printf("%s %s %s \"%s\" %d %u\n",myunit_testcase_inventory_tag,suite,name,file,line,(unsigned)asserts);
+#endif
 }
 
-
-/*!
-    \brief Configures assertion result printing based on verbosity level.
-    \details This block defines how passed and failed assertions are logged, depending on the `MYUNIT_ASSERT_VERBOSE_LEVEL`:
-             - If verbosity is set to level 2, both passed and failed assertions are printed.
-             - If verbosity is set to level 1, only failed assertions are printed.
-             - If verbosity is set to 0, neither passed nor failed assertions are printed.
-*/
 /*!
-    \def MYUNIT_ASSERT_PASSED_PRINTF
-    \brief Prints a message for a passed assertion if verbosity level is 2.
-    \param assert_result_text The result of the assertion (e.g., "PASS").
-    \param message The custom message associated with the assertion.
-    \param test The actual test condition that was evaluated.
+    \brief Prints the inventory of the test cases.
+    \details Prints a `<TCI>` record with the name, file, line and number of assertions of every test case
+             defined in the binary, ordered by file and line. The records are printed regardless of the
+             verbosity, they are the only output of a `MYUNIT_LIST_UNITTESTS` build.
+             The test cases are sorted in batches of `MYUNIT_INVENTORY_BATCH`, each batch takes one pass to
+             collect its test cases and one pass to count the assertions following each of them.
+    \note The stack use is bounded by `MYUNIT_INVENTORY_BATCH`, not by the size of the inventory.
+    \param suite The name of the test suite.
 */
+void myunit_inventory_print(const char *suite)
+{
+    const char *testcases[MYUNIT_INVENTORY_BATCH + 1];
+    uint32_t asserts[MYUNIT_INVENTORY_BATCH];
+    const char *record, *last = NULL, *file, *testcase_file;
+    size_t count, printed, pos, i;
+
+    do
+    {
+        /* The test cases following the last one printed, one more bounds the assertions of the batch */
+        count = 0;
+        for (record = myunit_inventory_first(); record < __stop_myunit_inventory; record = myunit_inventory_next(record))
+        {
+            if (record[0] != 'T' || (last && myunit_inventory_compare(record,last) <= 0)) continue;
+            pos = myunit_inventory_find(testcases,count,record);
+            if (pos > MYUNIT_INVENTORY_BATCH) continue;
+            if (count > MYUNIT_INVENTORY_BATCH) count--;
+            memmove(&testcases[pos + 1],&testcases[pos],(count - pos) * sizeof(testcases[0]));
+            testcases[pos] = record;
+            count++;
+        }
+        printed = (count > MYUNIT_INVENTORY_BATCH) ? MYUNIT_INVENTORY_BATCH : count;
+
+        memset(asserts,0x00,sizeof(asserts));
+        for (record = myunit_inventory_first(); record < __stop_myunit_inventory; record = myunit_inventory_next(record))
+        {
+            if (record[0] != 'A') continue;
+            pos = myunit_inventory_find(testcases,count,record);
+            if (pos == 0 || pos > printed) continue;
+            myunit_inventory_parse(record,NULL,&file);
+            myunit_inventory_parse(testcases[pos - 1],NULL,&testcase_file);
+            if (!strcmp(file,testcase_file)) asserts[pos - 1]++;
+        }
+
+        for (i = 0; i < printed; i++) myunit_inventory_print_testcase(suite,testcases[i],asserts[i]);
+        if (printed) last = testcases[printed - 1];
+    } while (count > MYUNIT_INVENTORY_BATCH);
+}
+
+#else
+    #define MYUNIT_INVENTORY_TESTCASE(name)
+    #define MYUNIT_INVENTORY_SITE()
+#endif
+
 /*!
-    \def MYUNIT_ASSERT_FAILED_PRINTF
-    \brief Prints a message for a failed assertion if verbosity level is 2 or 1.
-    \param assert_result_text The result of the assertion (e.g., "FAIL").
-    \param message The custom message associated with the assertion.
-    \param test The actual test condition that was evaluated.
+    \brief Prints the inventory and ends the test suite in a `MYUNIT_LIST_UNITTESTS` build, or if the runtime
+           option `MYUNIT_LIST` is set.
 */
-#if ( MYUNIT_ASSERT_VERBOSE_LEVEL  == 2 )
-    #define MYUNIT_ASSERT_PASSED_PRINTF(assert_result_text,message,test) MYUNIT_ASSERT_PRINTF(assert_result_text,message,test)
-    #define MYUNIT_ASSERT_FAILED_PRINTF(assert_result_text,message,test) MYUNIT_ASSERT_PRINTF(assert_result_text,message,test)
-#elif ( MYUNIT_ASSERT_VERBOSE_LEVEL  == 1 )
-    #define MYUNIT_ASSERT_PASSED_PRINTF(assert_result_text,message,test)
-    #define MYUNIT_ASSERT_FAILED_PRINTF(assert_result_text,message,test) MYUNIT_ASSERT_PRINTF(assert_result_text,message,test)
+#ifdef MYUNIT_LIST_UNITTESTS
+    #define MYUNIT_INVENTORY_LIST() \
+        do{myunit_inventory_print(const_myunit_testsuite_name); myunit_platform_deinit(); return 0;}while(0)
+#elif defined(MYUNIT_INVENTORY)
+    #define MYUNIT_INVENTORY_LIST() \
+        do{if(myunit_platform_option("MYUNIT_LIST")){myunit_inventory_print(const_myunit_testsuite_name); myunit_platform_deinit(); return 0;}}while(0)
 #else
-    #define MYUNIT_ASSERT_PASSED_PRINTF(assert_result_text,message,test)
-    #define MYUNIT_ASSERT_FAILED_PRINTF(assert_result_text,message,test)
+    #define MYUNIT_INVENTORY_LIST()
 #endif
 
 
@@ -488,19 +3188,48 @@ void myunit_exec_testcase(char *name, void(*testcase)())
     \param message A custom message associated with the assertion.
     \param test The test condition to be evaluated.
     \note The output behavior for passed and failed assertions depends on the verbosity level set by `MYUNIT_ASSERT_VERBOSE_LEVEL`.
+    \note With `MYUNIT_ASSERT_AGGREGATE` set, only the first results of an assertion evaluated in a loop are printed,
+          see `myunit_assert_sites_report`. The counters always include every result.
 */
 #define MYUNIT_ASSERT(message,test)                                                 \
     do{                                                                             \
+        MYUNIT_ASSERT_SITE();                                                       \
+        MYUNIT_INVENTORY_SITE();                                                    \
         if (!(test))                                                                \
         {                                                                           \
             myunit_testcase_assert_fail_count++;                                    \
-            MYUNIT_ASSERT_FAILED_PRINTF(myunit_testcase_failure_tag,message,test);  \
-            if(myunit_action) myunit_action();                                      \
+            if (MYUNIT_ASSERT_SITE_HIT(false))                                      \
+            {                                                                       \
+                MYUNIT_ASSERT_FAILED_PRINTF(myunit_testcase_failure_tag,message,test); \
+            }                                                                       \
+            MYUNIT_FAILURE_ACTION();                                                \
         }                                                                           \
         else                                                                        \
         {                                                                           \
             myunit_testcase_assert_success_count++;                                 \
-            MYUNIT_ASSERT_PASSED_PRINTF(myunit_testcase_passed_tag,message,test);   \
+            myunit_testcase_last_line = __LINE__;                                   \
+            if (MYUNIT_ASSERT_SITE_HIT(true))                                       \
+            {                                                                       \
+                MYUNIT_ASSERT_PASSED_PRINTF(myunit_testcase_passed_tag,message,test); \
+            }                                                                       \
+        }                                                                           \
+    }while(0)
+
+/*!
+    \brief Evaluates a test condition and aborts the test case if it fails.
+    \details Like `MYUNIT_ASSERT`, but a failure ends the running test case right away, so later checks that
+             depend on this one do not run. Execution continues with the next test case.
+    \param message A custom message associated with the assertion.
+    \param test The test condition to be evaluated.
+    \note Outside of a running test case, e.g. in a fixture teardown, it behaves like `MYUNIT_ASSERT`.
+*/
+#define MYUNIT_REQUIRE(message,test)                                                \
+    do{                                                                             \
+        int myunit_require_fail_count = myunit_testcase_assert_fail_count;          \
+        MYUNIT_ASSERT(message,test);                                                \
+        if (myunit_testcase_assert_fail_count != myunit_require_fail_count)         \
+        {                                                                           \
+            myunit_testcase_abort(MYUNIT_ABORT_REQUIRE);                            \
         }                                                                           \
     }while(0)
 
@@ -731,4 +3460,164 @@ void myunit_exec_testcase(char *name, void(*testcase)())
 #define MYUNIT_ASSERT_NOT_NULL(ptr)       \
     MYUNIT_ASSERT("IS_NULL", (ptr) != NULL )
 
+
+/*!
+    \brief Variants of the assertion macros that abort the test case on failure, see `MYUNIT_REQUIRE`.
+*/
+#define MYUNIT_REQUIRE_MEM_EQUAL(mem1,mem2,size) \
+    MYUNIT_REQUIRE("MEM_EQUAL",memcmp(mem1,mem2,size) == 0)
+
+#define MYUNIT_REQUIRE_MEM_DIFFER(mem1,mem2,size) \
+    MYUNIT_REQUIRE("MEM_DIFFERENT",memcmp(mem1,mem2,size) != 0)
+
+#define MYUNIT_REQUIRE_EQUAL(var1,var2) \
+    MYUNIT_REQUIRE("EQUAL",var1 == var2)
+
+#define MYUNIT_REQUIRE_DIFFER(var1,var2) \
+    MYUNIT_REQUIRE("DIFFER",var1 != var2)
+
+#define MYUNIT_REQUIRE_INRANGE(var,min,max) \
+    MYUNIT_REQUIRE("INRANGE",MYUNIT_INRANGE(var,min,max))
+
+#define MYUNIT_REQUIRE_CHECKPOINT_PASSED(idx) \
+    MYUNIT_REQUIRE("CHKPNT_PASSED", MYUNIT_CHECKPOINT_PASSED(idx))
+
+#define MYUNIT_REQUIRE_TRUE(cond) \
+    MYUNIT_REQUIRE("TRUE",  (cond) == true)
+
+#define MYUNIT_REQUIRE_FALSE(cond) \
+    MYUNIT_REQUIRE("FALSE",  (cond) == false)
+
+#define MYUNIT_REQUIRE_IS_NULL(ptr) \
+    MYUNIT_REQUIRE("IS_NULL", (ptr) == NULL )
+
+#define MYUNIT_REQUIRE_NOT_NULL(ptr) \
+    MYUNIT_REQUIRE("NOT_NULL", (ptr) != NULL )
+
+
+#ifndef MYUNIT_POLL_MIN_DELAY
+#define MYUNIT_POLL_MIN_DELAY 1 /*!< First delay between two polls in microseconds. */
+#endif
+
+#ifndef MYUNIT_POLL_MAX_DELAY
+#define MYUNIT_POLL_MAX_DELAY 10000 /*!< Longest delay between two polls in microseconds, the delay doubles up to it. */
+#endif
+
+/*!
+    \brief State of a polling assertion.
+*/
+typedef struct {
+    uint64_t start;     /*!< `myunit_platform_now` at the first poll */
+    uint64_t period;    /*!< Time the condition is polled in nanoseconds */
+    uint32_t delay;     /*!< Next delay in microseconds */
+    uint32_t polls;     /*!< Polls so far */
+} myunit_poll_t;
+
+/*!
+    \brief Starts polling a condition for `period` milliseconds.
+*/
+void myunit_poll_begin(myunit_poll_t *poll, uint32_t period)
+{
+    poll->start = myunit_platform_now();
+    poll->period = (uint64_t)period * 1000000u;
+    poll->delay = MYUNIT_POLL_MIN_DELAY;
+    poll->polls = 1;
+}
+
+/*!
+    \brief Waits for the next poll.
+    \details Yields with `myunit_platform_delay`, doubling the delay after every poll up to
+             `MYUNIT_POLL_MAX_DELAY`, but never past the end of the period. While the virtual clock is enabled,
+             the virtual time is advanced instead, so timers of the code under test fire while polling.
+    \return `false` if the period is over.
+*/
+bool myunit_poll_next(myunit_poll_t *poll)
+{
+    uint64_t elapsed = myunit_platform_now() - poll->start;
+    uint64_t remaining;
+    uint32_t delay;
+
+    if (elapsed >= poll->period) return false;
+
+    remaining = (poll->period - elapsed + 999u) / 1000u;
+    delay = (poll->delay < remaining) ? poll->delay : (uint32_t)remaining;
+    if (myunit_vclock_enabled()) myunit_vclock_advance((uint64_t)delay * 1000u);
+    else myunit_platform_delay(delay);
+
+    if (poll->delay < MYUNIT_POLL_MAX_DELAY) poll->delay = (poll->delay * 2 < MYUNIT_POLL_MAX_DELAY) ? poll->delay * 2 : MYUNIT_POLL_MAX_DELAY;
+    poll->polls++;
+    return true;
+}
+
+/*!
+    \brief Reports the elapsed time in microseconds and the polls of a failed polling assertion.
+*/
+void myunit_poll_report(const myunit_poll_t *poll, int line)
+{
+    MYUNIT_PRINTF("%s %s %s %d %u %u\n",myunit_testcase_wait_tag,myunit_testsuite_name,myunit_testcase_name,line,
+                  (unsigned)((myunit_platform_now() - poll->start) / 1000u),(unsigned)poll->polls);
+    (void)poll;
+    (void)line;
+}
+
+/*!
+    \brief Polls a test condition and evaluates it as one assertion.
+    \details Polls `test` as long as it evaluates to `hold` and the period has not elapsed, see
+             `myunit_poll_next`. The assertion passes if the last poll evaluates to `true`. On failure, a `<TCW>`
+             record with the elapsed time in microseconds and the number of polls follows the failure.
+    \param message A custom message associated with the assertion.
+    \param test The test condition, evaluated at every poll.
+    \param period Time to poll in milliseconds.
+    \param hold Result of `test` which continues polling.
+*/
+#define MYUNIT_ASSERT_POLL(message,test,period,hold)                                \
+    do{                                                                             \
+        myunit_poll_t myunit_poll;                                                  \
+        bool myunit_poll_holds;                                                     \
+        MYUNIT_ASSERT_SITE();                                                       \
+        MYUNIT_INVENTORY_SITE();                                                    \
+        myunit_poll_begin(&myunit_poll,(period));                                   \
+        while ((myunit_poll_holds = ((test) ? true : false)) == (hold) &&           \
+               myunit_poll_next(&myunit_poll));                                     \
+        if (!myunit_poll_holds)                                                     \
+        {                                                                           \
+            myunit_testcase_assert_fail_count++;                                    \
+            if (MYUNIT_ASSERT_SITE_HIT(false))                                      \
+            {                                                                       \
+                MYUNIT_ASSERT_FAILED_PRINTF(myunit_testcase_failure_tag,message,test); \
+                myunit_poll_report(&myunit_poll,__LINE__);                          \
+            }                                                                       \
+            MYUNIT_FAILURE_ACTION();                                                \
+        }                                                                           \
+        else                                                                        \
+        {                                                                           \
+            myunit_testcase_assert_success_count++;                                 \
+            myunit_testcase_last_line = __LINE__;                                   \
+            if (MYUNIT_ASSERT_SITE_HIT(true))                                       \
+            {                                                                       \
+                MYUNIT_ASSERT_PASSED_PRINTF(myunit_testcase_passed_tag,message,test); \
+            }                                                                       \
+        }                                                                           \
+    }while(0)
+
+/*!
+    \brief Asserts that a condition becomes true within a timeout.
+    \details Polls the condition with an adaptive backoff until it holds or `timeout` milliseconds have
+             elapsed, instead of sleeping for a fixed time and checking once. Counts as one assertion.
+    \param test The test condition, evaluated at every poll.
+    \param timeout Time to wait for the condition in milliseconds.
+*/
+#define MYUNIT_ASSERT_EVENTUALLY(test,timeout) \
+    MYUNIT_ASSERT_POLL("EVENTUALLY",test,timeout,false)
+
+/*!
+    \brief Asserts that a condition stays true for a duration.
+    \details Polls the condition with an adaptive backoff for `duration` milliseconds and fails as soon as
+             it does not hold. Counts as one assertion.
+    \param test The test condition, evaluated at every poll.
+    \param duration Time the condition must hold in milliseconds.
+*/
+#define MYUNIT_ASSERT_ALWAYS(test,duration) \
+    MYUNIT_ASSERT_POLL("ALWAYS",test,duration,true)
+
 #endif /* MYUNIT_H_ */
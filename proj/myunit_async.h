@@ -0,0 +1,317 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_async.h                                             *
+ *  Description : Cooperative asynchronous test cases                        *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_ASYNC_H_
+#define MYUNIT_ASYNC_H_
+
+#include "myunit.h"
+
+
+/*
+ * An asynchronous test case is a stackless coroutine: its body is a switch
+ * statement (Duff's device) which `MYUNIT_AWAIT` and `MYUNIT_YIELD` leave by
+ * return and re-enter at a case label on the next resume. The scheduler
+ * resumes all started test cases in turns on one thread, so test cases
+ * waiting for the code under test overlap instead of blocking each other.
+ *
+ * Local variables do not survive an await or yield, keep state which is
+ * needed across them in static variables. Only one await or yield may be
+ * written per source line, the line number is the resume point.
+ */
+
+
+#ifndef MYUNIT_ASYNC_SLOTS
+#define MYUNIT_ASYNC_SLOTS 8 /*!< Asynchronous test cases in flight at the same time. */
+#endif
+
+#define MYUNIT_ASYNC_PENDING    0   /*!< \brief The test case waits and is resumed in the next turn */
+#define MYUNIT_ASYNC_DONE       1   /*!< \brief The test case completed */
+
+
+/*!
+    \brief State of an asynchronous test case in flight.
+    \details While the test case is resumed its counters and aggregated assertions are swapped into those of
+             the running test case, so assertions count towards the test case which made them.
+*/
+typedef struct myunit_async myunit_async_t;
+struct myunit_async {
+    char *name;                                     /*!< Name of the test case */
+    int (*body)(myunit_async_t *myunit_async);      /*!< Coroutine of the test case */
+    int resume;                                     /*!< Line to resume at, 0 before the first turn */
+    int fail_count;                                 /*!< Failed assertions of the test case */
+    int success_count;                              /*!< Successful assertions of the test case */
+    int last_line;                                  /*!< Line of the last passed assertion of the test case */
+    uint32_t timeout;                               /*!< Timeout in milliseconds, 0 waits forever */
+    uint64_t start;                                 /*!< `myunit_platform_clock` when the test case started */
+    bool active;                                    /*!< The slot holds a test case in flight */
+#if ( MYUNIT_ASSERT_AGGREGATE > 0 )
+    myunit_assert_site_t *assert_sites;             /*!< Aggregated assertions of the test case */
+#endif
+};
+
+myunit_async_t myunit_async_slots[MYUNIT_ASYNC_SLOTS];  /*!< Asynchronous test cases in flight. */
+void (*myunit_async_idle)(void) = NULL;                 /*!< Called after every turn, see MYUNIT_SET_ASYNC_IDLE */
+
+/*!
+    \brief Swaps the aggregated assertions of a test case in and out of `myunit_assert_sites` around its turns,
+           so the `<TCA>` records of test cases in flight are not mixed up.
+*/
+#if ( MYUNIT_ASSERT_AGGREGATE > 0 )
+    #define MYUNIT_ASYNC_SITES_LOAD(slot) do{myunit_assert_sites = (slot)->assert_sites; (slot)->assert_sites = NULL;}while(0)
+    #define MYUNIT_ASYNC_SITES_SAVE(slot) do{(slot)->assert_sites = myunit_assert_sites; myunit_assert_sites = NULL;}while(0)
+#else
+    #define MYUNIT_ASYNC_SITES_LOAD(slot)
+    #define MYUNIT_ASYNC_SITES_SAVE(slot)
+#endif
+
+
+/*!
+    \brief Defines an asynchronous test case.
+    \details The body starts with `MYUNIT_ASYNC_BEGIN()` and ends with `MYUNIT_ASYNC_END()`. Start it with
+             `MYUNIT_START_ASYNC_TESTCASE(name)`.
+    \param name The name of the test case.
+*/
+#define MYUNIT_ASYNC_TESTCASE(name) \
+    MYUNIT_INVENTORY_TESTCASE(name) int myunit_async_##name(myunit_async_t *myunit_async)
+
+/*!
+    \brief Opens the body of an asynchronous test case.
+*/
+#define MYUNIT_ASYNC_BEGIN() switch (myunit_async->resume) { case 0:
+
+/*!
+    \brief Closes the body of an asynchronous test case.
+*/
+#define MYUNIT_ASYNC_END() } return MYUNIT_ASYNC_DONE
+
+/*!
+    \brief Marks the intended fall through into the resume label of `MYUNIT_AWAIT` for -Wimplicit-fallthrough.
+*/
+#if (defined(__GNUC__) && __GNUC__ >= 7) || defined(__clang__)
+    #define MYUNIT_ASYNC_FALLTHROUGH __attribute__((fallthrough))
+#else
+    #define MYUNIT_ASYNC_FALLTHROUGH ((void)0)
+#endif
+
+/*!
+    \brief Waits until a condition holds.
+    \details The condition is evaluated right away and again in every turn of the scheduler until it holds.
+             A test case whose timeout expires while waiting fails with the message "TIMEOUT" on the line of
+             the await.
+    \param cond The condition to wait for.
+*/
+#define MYUNIT_AWAIT(cond)                                                          \
+    do{                                                                             \
+        myunit_async->resume = __LINE__; MYUNIT_ASYNC_FALLTHROUGH; case __LINE__:   \
+        if (!(cond)) return MYUNIT_ASYNC_PENDING;                                   \
+    }while(0)
+
+/*!
+    \brief Gives the other asynchronous test cases a turn.
+*/
+#define MYUNIT_YIELD()                                                              \
+    do{                                                                             \
+        myunit_async->resume = __LINE__; return MYUNIT_ASYNC_PENDING; case __LINE__:; \
+    }while(0)
+
+/*!
+    \brief Starts an asynchronous test case with the test suite default timeout.
+    \param name The name of the test case.
+*/
+#define MYUNIT_START_ASYNC_TESTCASE(name) \
+    myunit_async_start(#name, myunit_async_##name, myunit_testsuite_timeout)
+
+/*!
+    \brief Starts an asynchronous test case with an explicit timeout.
+    \param name The name of the test case.
+    \param timeout Timeout in milliseconds, 0 waits forever.
+*/
+#define MYUNIT_START_ASYNC_TESTCASE_TIMEOUT(name,timeout) \
+    myunit_async_start(#name, myunit_async_##name, timeout)
+
+/*!
+    \brief Runs the started asynchronous test cases until all of them completed.
+*/
+#define MYUNIT_RUN_ASYNC_TESTCASES() myunit_async_run()
+
+/*!
+    \brief Sets the function called after every turn of the scheduler, e.g. to poll the code under test or
+           to advance the virtual clock. NULL removes it.
+*/
+#define MYUNIT_SET_ASYNC_IDLE(idle) do{myunit_async_idle = (idle);}while(0)
+
+
+/*!
+    \brief Completes an asynchronous test case.
+    \details Prints the `<TCE>` record and frees the slot.
+*/
+void myunit_async_finish(myunit_async_t *slot)
+{
+    myunit_testcase_name = slot->name;
+    myunit_testcase_assert_fail_count = slot->fail_count;
+    myunit_testcase_assert_success_count = slot->success_count;
+    myunit_testcase_last_line = slot->last_line;
+    MYUNIT_ASYNC_SITES_LOAD(slot);
+    slot->active = false;
+    myunit_testcase_end();
+}
+
+
+/*!
+    \brief Resumes an asynchronous test case for one turn.
+    \details A test case aborted by `MYUNIT_REQUIRE` or a fail-fast limit completes at the failed assertion.
+    \return `true` if the test case completed.
+*/
+bool myunit_async_resume(myunit_async_t *slot)
+{
+    int status;
+
+    myunit_testcase_name = slot->name;
+    myunit_testcase_assert_fail_count = slot->fail_count;
+    myunit_testcase_assert_success_count = slot->success_count;
+    myunit_testcase_last_line = slot->last_line;
+    myunit_testcase_seed = myunit_testsuite_seed;
+    MYUNIT_ASYNC_SITES_LOAD(slot);
+
+    switch (MYUNIT_SETJMP(myunit_testcase_jmp_buf))
+    {
+    case 0:
+        myunit_testcase_running = true;
+        status = slot->body(slot);
+        myunit_testcase_running = false;
+        break;
+    case MYUNIT_ABORT_REQUIRE:
+        myunit_testcase_running = false;
+        /* A REQUIRE failed inside a sequence is only counted by the sequence */
+        if (myunit_testcase_assert_fail_count == slot->fail_count) myunit_testcase_assert_fail_count++;
+        status = MYUNIT_ASYNC_DONE;
+        break;
+    default:
+        myunit_testcase_running = false;
+        status = MYUNIT_ASYNC_DONE;
+        break;
+    }
+
+    if (status == MYUNIT_ASYNC_PENDING && slot->timeout &&
+        myunit_platform_clock() - slot->start >= (uint64_t)slot->timeout * 1000000u)
+    {
+        myunit_testcase_assert_fail_count++;
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,slot->resume,"TIMEOUT","await expired");
+        MYUNIT_FAILURE_ACTION();
+        status = MYUNIT_ASYNC_DONE;
+    }
+
+    slot->fail_count = myunit_testcase_assert_fail_count;
+    slot->success_count = myunit_testcase_assert_success_count;
+    slot->last_line = myunit_testcase_last_line;
+    MYUNIT_ASYNC_SITES_SAVE(slot);
+
+    return status == MYUNIT_ASYNC_DONE;
+}
+
+
+/*!
+    \brief Runs the asynchronous test cases in flight until all of them completed.
+    \details Resumes the test cases in turns, each `<TCE>` record is printed when its test case completes.
+             After a fail-fast limit is reached, the test cases still in flight complete right away. Afterwards
+             the guarded buffers and the arena are released, the virtual clock is switched off and the mocks
+             are reset.
+*/
+void myunit_async_run(void)
+{
+    bool pending;
+    int idx;
+
+    do
+    {
+        pending = false;
+        for (idx = 0; idx < MYUNIT_ASYNC_SLOTS; idx++)
+        {
+            myunit_async_t *slot = &myunit_async_slots[idx];
+
+            if (!slot->active) continue;
+            if (myunit_testsuite_stopped || myunit_async_resume(slot)) myunit_async_finish(slot);
+            else pending = true;
+        }
+        if (pending && myunit_async_idle) myunit_async_idle();
+    } while (pending);
+
+    myunit_guards_release();
+    MYUNIT_ARENA_RESET();
+    if(myunit_vclock_enabled()) myunit_vclock_enable(false);
+    myunit_mocks_reset();
+}
+
+
+/*!
+    \brief Starts an asynchronous test case.
+    \details Prints the `<TCB>` record and runs the first turn of the test case. If all slots are in flight, the
+             test cases in flight are run to completion first. Test cases are filtered and skipped like
+             regular test cases, fixtures, isolation and repetitions do not apply.
+    \param name The name of the test case, used for logging purposes.
+    \param body The coroutine of the test case.
+    \param timeout Timeout in milliseconds, 0 waits forever.
+*/
+void myunit_async_start(char *name, int (*body)(myunit_async_t *myunit_async), uint32_t timeout)
+{
+    myunit_async_t *slot = NULL;
+    int idx;
+
+    if (!myunit_testcase_selected(name)) return;
+    if (myunit_testsuite_stopped)
+    {
+        myunit_testcase_skip_count++;
+        MYUNIT_PRINTF("%s %s %s\n",myunit_testcase_skipped_tag,myunit_testsuite_name,name);
+        return;
+    }
+
+    for (idx = 0; !slot; idx = (idx + 1) % MYUNIT_ASYNC_SLOTS)
+    {
+        if (!myunit_async_slots[idx].active) slot = &myunit_async_slots[idx];
+        else if (idx == MYUNIT_ASYNC_SLOTS - 1) myunit_async_run();
+    }
+
+    myunit_testcase_begin(name);
+    slot->name = name;
+    slot->body = body;
+    slot->resume = 0;
+    slot->fail_count = slot->success_count = slot->last_line = 0;
+    slot->timeout = timeout;
+    slot->start = myunit_platform_clock();
+    slot->active = true;
+
+    if (myunit_async_resume(slot)) myunit_async_finish(slot);
+}
+
+#endif /* MYUNIT_ASYNC_H_ */
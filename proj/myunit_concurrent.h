@@ -0,0 +1,273 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_concurrent.h                                        *
+ *  Description : Concurrency stress test cases                              *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_CONCURRENT_H_
+#define MYUNIT_CONCURRENT_H_
+
+#include "myunit.h"
+
+
+/*
+ * A concurrent body runs on several threads at once, each pinned to its own
+ * processor by `myunit_platform_threads_start`. The iterations are split
+ * into lockstep rounds: all threads start a round together behind a
+ * barrier, and after all of them finished it the invariant is checked while
+ * they wait. The regular assertion macros are not thread safe, the body
+ * uses `MYUNIT_CONCURRENT_ASSERT`, which counts per thread. A port without
+ * threads runs the shares of the threads one after the other.
+ */
+
+
+#ifndef MYUNIT_CONCURRENT_THREADS
+#define MYUNIT_CONCURRENT_THREADS 8 /*!< Largest number of threads of `MYUNIT_CONCURRENT`. */
+#endif
+
+#ifndef MYUNIT_CONCURRENT_ROUNDS
+#define MYUNIT_CONCURRENT_ROUNDS 16 /*!< Default number of lockstep rounds, see MYUNIT_SET_CONCURRENT_ROUNDS */
+#endif
+
+#ifndef MYUNIT_CONCURRENT_CACHE_LINE
+#define MYUNIT_CONCURRENT_CACHE_LINE 64 /*!< Alignment of the per-thread results, keeps them in separate cache lines. */
+#endif
+
+
+/*!
+    \brief Results of one thread, only written by this thread.
+*/
+typedef struct {
+    uint32_t success_count;                 /*!< Successful assertions */
+    uint32_t fail_count;                    /*!< Failed assertions */
+    uint32_t iterations;                    /*!< Iterations run */
+    int fail_line;                          /*!< Line of the first failed assertion */
+    uint32_t fail_iteration;                /*!< Iteration of the first failed assertion */
+    const char *fail_test;                  /*!< Condition of the first failed assertion */
+    uint64_t busy;                          /*!< Nanoseconds spent in the body */
+} __attribute__((aligned(MYUNIT_CONCURRENT_CACHE_LINE))) myunit_concurrent_thread_t;
+
+myunit_concurrent_thread_t myunit_concurrent_threads[MYUNIT_CONCURRENT_THREADS]; /*!< Results of the threads. */
+void (*myunit_concurrent_body)(unsigned thread, uint32_t iteration);             /*!< Body of the running stress test. */
+uint32_t myunit_concurrent_iterations;                                          /*!< Iterations of each thread. */
+volatile bool myunit_concurrent_stopped;                                        /*!< The invariant failed, no further rounds. */
+uint32_t myunit_concurrent_rounds = MYUNIT_CONCURRENT_ROUNDS;                   /*!< Lockstep rounds, see MYUNIT_SET_CONCURRENT_ROUNDS */
+bool (*myunit_concurrent_invariant)(void) = NULL;                               /*!< Invariant, see MYUNIT_SET_CONCURRENT_INVARIANT */
+const char *myunit_concurrent_invariant_name = NULL;                            /*!< Name of the invariant */
+
+
+/*!
+    \brief Defines the body of a concurrent stress test.
+    \details The body is called once per iteration on every thread. `MYUNIT_THREAD()` and `MYUNIT_ITERATION()`
+             return the thread running it and the iteration.
+    \param name The name of the body.
+*/
+#define MYUNIT_CONCURRENT_BODY(name) \
+    void myunit_concurrent_##name(unsigned myunit_thread, uint32_t myunit_iteration)
+
+#define MYUNIT_THREAD()     (myunit_thread)     /*!< \brief Thread running the concurrent body, from 0 */
+#define MYUNIT_ITERATION()  (myunit_iteration)  /*!< \brief Iteration of the concurrent body on this thread, from 0 */
+
+/*!
+    \brief Checks a condition inside a concurrent body.
+    \details The result is counted for the running thread and reported by `MYUNIT_CONCURRENT` after the
+             threads ended.
+    \param cond The condition to check.
+*/
+#define MYUNIT_CONCURRENT_ASSERT(cond)                                              \
+    do{                                                                             \
+        MYUNIT_INVENTORY_SITE();                                                    \
+        myunit_concurrent_check(myunit_thread,myunit_iteration,(cond),__LINE__,#cond); \
+    }while(0)
+
+/*!
+    \brief Runs a concurrent body on several threads.
+    \details Every thread runs `iterations` iterations of the body, split into lockstep rounds. Results are
+             added to the running test case, each thread reports its first failed assertion and a `<TCC>`
+             record with its throughput.
+    \param nthreads Number of threads, up to `MYUNIT_CONCURRENT_THREADS`.
+    \param iterations Iterations of each thread.
+    \param body The name of the body defined by `MYUNIT_CONCURRENT_BODY`.
+*/
+#define MYUNIT_CONCURRENT(nthreads,iterations,body) \
+    myunit_concurrent_run(nthreads, iterations, myunit_concurrent_##body)
+
+/*!
+    \brief Sets the invariant checked after every round.
+    \details The invariant is called while all threads wait and returns `false` if the shared state is
+             broken. A broken invariant fails the test case with the message "INVARIANT" and ends the stress
+             test. NULL removes it.
+*/
+#define MYUNIT_SET_CONCURRENT_INVARIANT(invariant) \
+    do{myunit_concurrent_invariant = (invariant); myunit_concurrent_invariant_name = #invariant;}while(0)
+
+/*!
+    \brief Sets the number of lockstep rounds the iterations are split into.
+*/
+#define MYUNIT_SET_CONCURRENT_ROUNDS(rounds) do{myunit_concurrent_rounds = (rounds);}while(0)
+
+
+/*!
+    \brief Counts the result of `MYUNIT_CONCURRENT_ASSERT` for a thread.
+*/
+void myunit_concurrent_check(unsigned thread, uint32_t iteration, bool passed, int line, const char *test)
+{
+    myunit_concurrent_thread_t *state = &myunit_concurrent_threads[thread];
+
+    if (passed)
+    {
+        state->success_count++;
+        return;
+    }
+    if (!state->fail_count++)
+    {
+        state->fail_line = line;
+        state->fail_iteration = iteration;
+        state->fail_test = test;
+    }
+}
+
+
+/*!
+    \brief Runs the share of a thread in one round.
+*/
+void myunit_concurrent_round(unsigned thread, uint32_t round)
+{
+    myunit_concurrent_thread_t *state = &myunit_concurrent_threads[thread];
+    uint32_t iteration = (uint32_t)((uint64_t)myunit_concurrent_iterations * round / myunit_concurrent_rounds);
+    uint32_t end = (uint32_t)((uint64_t)myunit_concurrent_iterations * (round + 1) / myunit_concurrent_rounds);
+    uint64_t begin = myunit_platform_clock();
+
+    for (; iteration < end; iteration++) myunit_concurrent_body(thread,iteration);
+    state->busy += myunit_platform_clock() - begin;
+    state->iterations = end;
+}
+
+
+/*!
+    \brief Checks the invariant after a round.
+*/
+void myunit_concurrent_check_invariant(void)
+{
+    if (!myunit_concurrent_invariant || myunit_concurrent_invariant()) return;
+
+    myunit_concurrent_stopped = true;
+    myunit_testcase_assert_fail_count++;
+    MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"INVARIANT",myunit_concurrent_invariant_name);
+}
+
+
+/*!
+    \brief Rounds of one thread, started by `myunit_platform_threads_start`.
+*/
+void myunit_concurrent_worker(unsigned thread)
+{
+    uint32_t round;
+
+    for (round = 0; round < myunit_concurrent_rounds; round++)
+    {
+        myunit_platform_threads_barrier();
+        if (myunit_concurrent_stopped) break;
+        myunit_concurrent_round(thread,round);
+        myunit_platform_threads_barrier();
+    }
+}
+
+
+/*!
+    \brief Runs a concurrent body on several threads, see `MYUNIT_CONCURRENT`.
+    \details The calling thread coordinates the rounds and checks the invariant. The results of the threads
+             are added to the running test case after all threads ended, failures are handled by the
+             failure action once.
+    \param threads Number of threads.
+    \param iterations Iterations of each thread.
+    \param body The body.
+*/
+void myunit_concurrent_run(unsigned threads, uint32_t iterations, void (*body)(unsigned thread, uint32_t iteration))
+{
+    int fail_count = myunit_testcase_assert_fail_count;
+    uint32_t round;
+    unsigned thread;
+
+    if (threads == 0 || threads > MYUNIT_CONCURRENT_THREADS)
+    {
+        myunit_testcase_assert_fail_count++;
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_testcase_last_line,"CONCURRENT","thread count out of range");
+        MYUNIT_FAILURE_ACTION();
+        return;
+    }
+
+    memset(myunit_concurrent_threads,0x00,sizeof(myunit_concurrent_threads));
+    myunit_concurrent_body = body;
+    myunit_concurrent_iterations = iterations;
+    myunit_concurrent_stopped = false;
+    if (myunit_concurrent_rounds == 0) myunit_concurrent_rounds = 1;
+
+    if (myunit_platform_threads_start(threads,myunit_concurrent_worker))
+    {
+        for (round = 0; round < myunit_concurrent_rounds; round++)
+        {
+            myunit_platform_threads_barrier();
+            if (myunit_concurrent_stopped) break;
+            myunit_platform_threads_barrier();
+            myunit_concurrent_check_invariant();
+        }
+        myunit_platform_threads_join();
+    }
+    else
+    {
+        for (round = 0; round < myunit_concurrent_rounds && !myunit_concurrent_stopped; round++)
+        {
+            for (thread = 0; thread < threads; thread++) myunit_concurrent_round(thread,round);
+            myunit_concurrent_check_invariant();
+        }
+    }
+
+    for (thread = 0; thread < threads; thread++)
+    {
+        myunit_concurrent_thread_t *state = &myunit_concurrent_threads[thread];
+
+        myunit_testcase_assert_success_count += (int)state->success_count;
+        myunit_testcase_assert_fail_count += (int)state->fail_count;
+        if (state->fail_count)
+        {
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,state->fail_line,"CONCURRENT",state->fail_test);
+        }
+        MYUNIT_PRINTF("%s %s %s %u %u %llu %u %ld\n",myunit_testcase_concurrent_tag,myunit_testsuite_name,myunit_testcase_name,
+                      thread,(unsigned)state->iterations,
+                      state->busy ? (unsigned long long)((uint64_t)state->iterations * 1000000000u / state->busy) : 0ULL,
+                      (unsigned)state->fail_count,state->fail_count ? (long)state->fail_iteration : -1L);
+    }
+
+    if (myunit_testcase_assert_fail_count != fail_count) MYUNIT_FAILURE_ACTION();
+}
+
+#endif /* MYUNIT_CONCURRENT_H_ */
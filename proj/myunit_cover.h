@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_cover.h                                             *
+ *  Description : Coverage sites for the code under test                     *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_COVER_H_
+#define MYUNIT_COVER_H_
+
+/*
+ * Like myunit_vclock.h, this header only contains declarations. It may be
+ * included by the code under test in any number of modules.
+ */
+
+#include <stdint.h>
+
+
+/*!
+    \brief Coverage site, one per `MYUNIT_COVER()`.
+    \details The sites are placed in the linker section `myunit_cover`, which myunit walks at the end of the
+             test suite to report the sites never reached.
+*/
+typedef struct {
+    const char *file;       /*!< File of the site */
+    uint32_t line;          /*!< Line of the site */
+    uint8_t reached;        /*!< Set to 1 when the site is reached */
+} myunit_cover_t;
+
+/*!
+    \def MYUNIT_COVER
+    \brief Marks a coverage site in the code under test.
+    \details Each call site gets its own `myunit_cover_t` at compile time, so sites need no numbering. At
+             runtime, reaching the site costs a single byte store. Without `MYUNIT_COVERAGE` defined, the
+             macro expands to nothing, so the sites can stay in production code.
+    \note Requires a GCC compatible compiler and a linker providing `__start_` and `__stop_` symbols of
+          sections, as GNU ld and lld on ELF targets do.
+*/
+#ifdef MYUNIT_COVERAGE
+    #define MYUNIT_COVER()                                                                          \
+        do{                                                                                         \
+            static myunit_cover_t myunit_cover_site __attribute__((section("myunit_cover"),used)) = \
+                {__FILE__, __LINE__, 0};                                                            \
+            myunit_cover_site.reached = 1;                                                          \
+        }while(0)
+#else
+    #define MYUNIT_COVER() do{}while(0)
+#endif
+
+#endif /* MYUNIT_COVER_H_ */
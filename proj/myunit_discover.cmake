@@ -0,0 +1,69 @@
+# Discovers the test cases of a test suite built by myunit_add_suite() and
+# writes a CTest file which registers every test case as a test of its own.
+#
+#   TEST_EXECUTABLE   test suite, built with MYUNIT_INVENTORY
+#   TEST_PREFIX       prefix of the test names, <prefix>.<test case>
+#   TEST_TIMEOUT      timeout of each test case in seconds, 0 for none
+#   TEST_EXPECT_FAIL  comma separated test cases which are expected to fail
+#   TEST_HISTORY      history file of a suite built with MYUNIT_HISTORY, optional
+#   CTEST_FILE        CTest file to write
+
+set(ENV{MYUNIT_LIST} 1)
+if (TEST_HISTORY)
+    set(ENV{MYUNIT_HISTORY} "${TEST_HISTORY}")
+endif()
+execute_process(
+    COMMAND "${TEST_EXECUTABLE}"
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE result
+)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "myunit: listing the test cases of ${TEST_EXECUTABLE} failed: ${result}")
+endif()
+
+string(REPLACE "," ";" expect_fail "${TEST_EXPECT_FAIL}")
+string(REGEX MATCHALL "<TCI> [^\n]*" records "${output}")
+if (NOT records)
+    message(WARNING "myunit: ${TEST_EXECUTABLE} has no test cases, is it built with MYUNIT_INVENTORY?")
+endif()
+
+set(content "# Generated by myunit_discover.cmake from ${TEST_EXECUTABLE}\n")
+foreach(record IN LISTS records)
+    string(REGEX MATCH "^<TCI> ([^ ]+) ([^ ]+) " match "${record}")
+    set(suite "${CMAKE_MATCH_1}")
+    set(testcase "${CMAKE_MATCH_2}")
+    set(test "${TEST_PREFIX}.${testcase}")
+
+    set(environment "MYUNIT_FILTER=${testcase}")
+    set(properties "")
+    if (TEST_HISTORY)
+        # The duration of the last run lets ctest -j start the longest test cases first.
+        set(environment "${environment};MYUNIT_HISTORY=${TEST_HISTORY}")
+        if (record MATCHES "^<TCI> [^ ]+ [^ ]+ \"[^\"]*\" [0-9]+ [0-9]+ ([0-9]+)" AND NOT CMAKE_MATCH_1 EQUAL 0)
+            math(EXPR cost "${CMAKE_MATCH_1} / 1000 + 1")
+            string(APPEND properties " COST ${cost}")
+        endif()
+    endif()
+    if (TEST_TIMEOUT)
+        # The watchdog reports the hang as a failed test case, CTest only kills the process if that fails.
+        math(EXPR watchdog "${TEST_TIMEOUT} * 1000")
+        math(EXPR backstop "${TEST_TIMEOUT} + 5")
+        set(environment "${environment};MYUNIT_TIMEOUT=${watchdog}")
+        string(APPEND properties " TIMEOUT ${backstop}")
+    endif()
+    list(FIND expect_fail "${testcase}" expected)
+    if (NOT expected EQUAL -1)
+        string(APPEND properties " WILL_FAIL TRUE")
+    endif()
+
+    string(APPEND content
+        "add_test([==[${test}]==] [==[${TEST_EXECUTABLE}]==])\n"
+        "set_tests_properties([==[${test}]==] PROPERTIES\n"
+        "    ENVIRONMENT [==[${environment}]==]\n"
+        "    PASS_REGULAR_EXPRESSION [==[<TCE> ${suite} ${testcase}(\\[[0-9]+\\])? ]==]\n"
+        "    FAIL_REGULAR_EXPRESSION [==[<TCE> [^ ]+ [^ ]+ [1-9]|<TCS> ]==]\n"
+        "    SKIP_REGULAR_EXPRESSION [==[<TCU> ${suite} ${testcase}]==]${properties})\n"
+    )
+endforeach()
+
+file(WRITE "${CTEST_FILE}" "${content}")
@@ -0,0 +1,191 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_fuzz.h                                              *
+ *  Description : Fuzz test cases for libFuzzer and AFL                      *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_FUZZ_H_
+#define MYUNIT_FUZZ_H_
+
+#include "myunit.h"
+
+
+/*
+ * A fuzz test case is built in one of three ways, selected at compile time:
+ *
+ *  - default:               a regular test case replaying a checked-in corpus
+ *  - MYUNIT_FUZZ_LIBFUZZER: LLVMFuzzerTestOneInput entry point, link with -fsanitize=fuzzer
+ *  - MYUNIT_FUZZ_AFL:       main with an AFL persistent mode loop reading stdin
+ *
+ * The fuzz builds need MYUNIT_FUZZ_TARGET set to the name of the fuzz test
+ * case, failed assertions abort the process (see MYUNIT_ABORT_ON_FAILURE).
+ */
+
+
+#ifndef MYUNIT_FUZZ_CORPUS_DIR
+#define MYUNIT_FUZZ_CORPUS_DIR "corpus" /*!< Directory holding one corpus directory per fuzz test case. */
+#endif
+
+#ifndef MYUNIT_FUZZ_MAX_INPUT
+#define MYUNIT_FUZZ_MAX_INPUT 65536 /*!< Largest input of the AFL harness in bytes, longer inputs are truncated. */
+#endif
+
+#ifndef MYUNIT_FUZZ_AFL_LOOPS
+#define MYUNIT_FUZZ_AFL_LOOPS 10000 /*!< Inputs processed by one AFL persistent mode process. */
+#endif
+
+
+/*!
+    \brief Defines a fuzz test case.
+    \details The body following the macro receives one input of `size` bytes at `data` and checks the code
+             under test with the regular assertion macros. Execute it with `MYUNIT_EXEC_FUZZ_TESTCASE(name)`.
+    \param name The name of the fuzz test case.
+    \param data Name of the `const uint8_t *` parameter holding the input.
+    \param size Name of the `size_t` parameter holding the input length.
+*/
+#define MYUNIT_FUZZ_TESTCASE(name,data,size) \
+    MYUNIT_INVENTORY_TESTCASE(name) void myunit_fuzz_##name(const uint8_t *data, size_t size)
+
+/*!
+    \brief Executes a fuzz test case on its corpus.
+    \details Runs the fuzz test case as one test case which feeds every input of the corpus directory
+             `MYUNIT_FUZZ_CORPUS_DIR/name` to it. A missing or empty corpus fails the test case.
+    \param name The name of the fuzz test case.
+*/
+#define MYUNIT_EXEC_FUZZ_TESTCASE(name) \
+    myunit_exec_fuzz_testcase(#name, myunit_fuzz_##name, MYUNIT_FUZZ_CORPUS_DIR "/" #name)
+
+
+void (*myunit_fuzz_target)(const uint8_t *data, size_t size);  /*!< Fuzz test case replaying its corpus */
+const char *myunit_fuzz_corpus;                                 /*!< Corpus of the replayed fuzz test case */
+
+
+/*!
+    \brief Test case feeding the corpus to the current fuzz test case.
+*/
+void myunit_fuzz_replay(void)
+{
+    int inputs = myunit_platform_corpus(myunit_fuzz_corpus,myunit_fuzz_target);
+
+    MYUNIT_ASSERT("CORPUS", inputs > 0);
+}
+
+/*!
+    \brief Executes a fuzz test case on a corpus.
+    \param name The name of the test case, used for logging purposes.
+    \param target The fuzz test case.
+    \param corpus Location of the corpus passed to `myunit_platform_corpus`.
+*/
+void myunit_exec_fuzz_testcase(char *name, void (*target)(const uint8_t *data, size_t size), const char *corpus)
+{
+    myunit_fuzz_target = target;
+    myunit_fuzz_corpus = corpus;
+    myunit_exec_testcase(name,myunit_fuzz_replay);
+}
+
+
+#define MYUNIT_FUZZ_CONCAT_(a,b)    a##b
+#define MYUNIT_FUZZ_STR_(x)         #x
+#define MYUNIT_FUZZ_FUNCTION(name)  MYUNIT_FUZZ_CONCAT_(myunit_fuzz_,name)
+#define MYUNIT_FUZZ_NAME(name)      MYUNIT_FUZZ_STR_(name)
+
+/*!
+    \brief Prepares the platform and the test suite before the first fuzz input.
+    \details The test suite setup runs once, the teardown never runs since fuzzers end the process.
+*/
+#define MYUNIT_FUZZ_BEGIN()                                                         \
+    do{                                                                             \
+        static bool myunit_fuzz_initialized = false;                                \
+        if (!myunit_fuzz_initialized)                                               \
+        {                                                                           \
+            myunit_platform_init();                                                 \
+            myunit_testsuite_setup();                                               \
+            myunit_testsuite_name = (char*)const_myunit_testsuite_name;             \
+            myunit_testcase_name = (char*)MYUNIT_FUZZ_NAME(MYUNIT_FUZZ_TARGET);     \
+            myunit_fuzz_initialized = true;                                         \
+        }                                                                           \
+    }while(0)
+
+
+#if defined(MYUNIT_FUZZ_LIBFUZZER) || defined(MYUNIT_FUZZ_AFL)
+    #ifndef MYUNIT_FUZZ_TARGET
+        #error "MYUNIT : MYUNIT_FUZZ_TARGET must name the fuzz test case of a fuzz build"
+    #endif
+#endif
+
+/*!
+    \def MYUNIT_FUZZ_ENTRY
+    \brief Defines the entry point of a fuzz build, expanded by `MYUNIT_TESTSUITE`.
+*/
+#if defined(MYUNIT_FUZZ_LIBFUZZER)
+
+#define MYUNIT_FUZZ_ENTRY()                                                         \
+    void MYUNIT_FUZZ_FUNCTION(MYUNIT_FUZZ_TARGET)(const uint8_t *data, size_t size);\
+    int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)                    \
+    {                                                                               \
+        MYUNIT_FUZZ_BEGIN();                                                        \
+        MYUNIT_FUZZ_FUNCTION(MYUNIT_FUZZ_TARGET)(data,size);                        \
+        return 0;                                                                   \
+    }
+
+#elif defined(MYUNIT_FUZZ_AFL)
+
+#include <unistd.h>
+
+#ifndef __AFL_LOOP
+    #define __AFL_LOOP(count) (myunit_fuzz_afl_once++ == 0) /*!< Single input per process without afl-clang-fast */
+    static int myunit_fuzz_afl_once = 0;
+#endif
+
+uint8_t myunit_fuzz_input[MYUNIT_FUZZ_MAX_INPUT];   /*!< Input buffer of the AFL harness */
+
+#define MYUNIT_FUZZ_ENTRY()                                                         \
+    void MYUNIT_FUZZ_FUNCTION(MYUNIT_FUZZ_TARGET)(const uint8_t *data, size_t size);\
+    int main()                                                                      \
+    {                                                                               \
+        MYUNIT_FUZZ_BEGIN();                                                        \
+        while (__AFL_LOOP(MYUNIT_FUZZ_AFL_LOOPS))                                   \
+        {                                                                           \
+            size_t size = 0;                                                        \
+            ssize_t len;                                                            \
+            while (size < sizeof(myunit_fuzz_input) &&                              \
+                   (len = read(0,myunit_fuzz_input + size,sizeof(myunit_fuzz_input) - size)) > 0) \
+            {                                                                       \
+                size += (size_t)len;                                                \
+            }                                                                       \
+            MYUNIT_FUZZ_FUNCTION(MYUNIT_FUZZ_TARGET)(myunit_fuzz_input,size);       \
+        }                                                                           \
+        return EXIT_SUCCESS;                                                        \
+    }
+
+#endif
+
+#endif /* MYUNIT_FUZZ_H_ */
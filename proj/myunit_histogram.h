@@ -0,0 +1,249 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_histogram.h                                         *
+ *  Description : Fixed-memory latency histograms                            *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_HISTOGRAM_H_
+#define MYUNIT_HISTOGRAM_H_
+
+#include "myunit.h"
+
+
+/*
+ * A histogram counts values, typically latencies in nanoseconds, in
+ * log-linear buckets like an HDR histogram: values below
+ * 2^MYUNIT_HISTOGRAM_PRECISION get a bucket each, above that every power of
+ * two is split into 2^(MYUNIT_HISTOGRAM_PRECISION - 1) buckets of equal
+ * width. A bucket is thus never wider than 1/2^(MYUNIT_HISTOGRAM_PRECISION - 1)
+ * of the values it holds. The memory is fixed at compile time and recording a
+ * value takes constant time, so percentiles of millions of samples can be
+ * asserted without storing the samples.
+ */
+
+
+#ifndef MYUNIT_HISTOGRAM_PRECISION
+#define MYUNIT_HISTOGRAM_PRECISION 5 /*!< Bits of precision, 5 bounds the bucket width to 6.25% of its values. */
+#endif
+
+#ifndef MYUNIT_HISTOGRAM_RANGE
+#define MYUNIT_HISTOGRAM_RANGE 32 /*!< Bits of the largest value, larger values are counted in the last bucket. */
+#endif
+
+#if (MYUNIT_HISTOGRAM_PRECISION < 1) || (MYUNIT_HISTOGRAM_PRECISION > MYUNIT_HISTOGRAM_RANGE) || (MYUNIT_HISTOGRAM_RANGE > 32)
+    #error "MYUNIT : MYUNIT_HISTOGRAM_PRECISION must be at least 1 and at most MYUNIT_HISTOGRAM_RANGE, which is at most 32"
+#endif
+
+#define MYUNIT_HISTOGRAM_HALF       (1u << (MYUNIT_HISTOGRAM_PRECISION - 1))    /*!< Buckets per power of two */
+#define MYUNIT_HISTOGRAM_BUCKETS    ((MYUNIT_HISTOGRAM_RANGE - MYUNIT_HISTOGRAM_PRECISION + 2) * MYUNIT_HISTOGRAM_HALF) /*!< Buckets of a histogram */
+
+#define myunit_histogram_summary_tag    "<HGS>" /*!< Tag summarizing a histogram */
+#define myunit_histogram_bucket_tag     "<HGB>" /*!< Tag reporting a bucket of a histogram */
+
+
+/*!
+    \brief Histogram of values, see `myunit_histogram_record`.
+    \details Zero initialized, e.g. as a static variable or by `myunit_histogram_reset`, the histogram is empty.
+*/
+typedef struct {
+    uint32_t counts[MYUNIT_HISTOGRAM_BUCKETS];  /*!< Values counted per bucket */
+    uint32_t count;                             /*!< Values recorded */
+    uint32_t min;                               /*!< Smallest value recorded */
+    uint32_t max;                               /*!< Largest value recorded */
+} myunit_histogram_t;
+
+
+/*!
+    \brief Empties a histogram.
+*/
+void myunit_histogram_reset(myunit_histogram_t *histogram)
+{
+    memset(histogram,0,sizeof(*histogram));
+}
+
+/*!
+    \brief Returns the bucket of a value.
+*/
+uint32_t myunit_histogram_index(uint32_t value)
+{
+    uint32_t msb = 0, shift;
+
+#if MYUNIT_HISTOGRAM_RANGE < 32
+    if (value >> MYUNIT_HISTOGRAM_RANGE) value = (1u << MYUNIT_HISTOGRAM_RANGE) - 1u;
+#endif
+    if (value < 2u * MYUNIT_HISTOGRAM_HALF) return value;
+
+#if defined(__GNUC__)
+    msb = 31u - (uint32_t)__builtin_clz(value);
+#else
+    while (value >> (msb + 1u)) msb++;
+#endif
+    shift = msb - MYUNIT_HISTOGRAM_PRECISION + 1u;
+    return shift * MYUNIT_HISTOGRAM_HALF + (value >> shift);
+}
+
+/*!
+    \brief Returns the smallest value of a bucket and sets `high` to its largest value.
+*/
+uint32_t myunit_histogram_bounds(uint32_t index, uint32_t *high)
+{
+    uint32_t shift, low;
+
+    if (index < 2u * MYUNIT_HISTOGRAM_HALF)
+    {
+        *high = index;
+        return index;
+    }
+    shift = index / MYUNIT_HISTOGRAM_HALF - 1u;
+    low = (index - shift * MYUNIT_HISTOGRAM_HALF) << shift;
+    *high = low + ((1u << shift) - 1u);
+    return low;
+}
+
+/*!
+    \brief Records a value in constant time.
+    \param histogram The histogram.
+    \param value The value, e.g. a latency in nanoseconds.
+*/
+void myunit_histogram_record(myunit_histogram_t *histogram, uint32_t value)
+{
+    histogram->counts[myunit_histogram_index(value)]++;
+    if (!histogram->count || value < histogram->min) histogram->min = value;
+    if (value > histogram->max) histogram->max = value;
+    histogram->count++;
+}
+
+/*!
+    \brief Adds the values of `source` to `histogram`.
+    \details Lets each thread record into a histogram of its own, merged once the threads are done.
+*/
+void myunit_histogram_merge(myunit_histogram_t *histogram, const myunit_histogram_t *source)
+{
+    uint32_t idx;
+
+    if (!source->count) return;
+    for (idx = 0; idx < MYUNIT_HISTOGRAM_BUCKETS; idx++) histogram->counts[idx] += source->counts[idx];
+    if (!histogram->count || source->min < histogram->min) histogram->min = source->min;
+    if (source->max > histogram->max) histogram->max = source->max;
+    histogram->count += source->count;
+}
+
+/*!
+    \brief Returns a percentile of the recorded values.
+    \details The value returned is the largest value of the bucket holding the percentile, but at most the
+             largest value recorded. It is thus never below the exact percentile, so an upper bound asserted on
+             it holds for the samples as well.
+    \param histogram The histogram.
+    \param percentile The percentile, e.g. 99.9.
+    \return The percentile, 0 if the histogram is empty.
+*/
+uint32_t myunit_histogram_percentile(const myunit_histogram_t *histogram, double percentile)
+{
+    double target = percentile / 100.0 * (double)histogram->count;
+    uint32_t rank = (uint32_t)target;
+    uint32_t idx, seen = 0, high = 0;
+
+    if (!histogram->count) return 0;
+    if ((double)rank < target) rank++;
+    if (rank < 1u) rank = 1u;
+    if (rank > histogram->count) rank = histogram->count;
+
+    for (idx = 0; idx < MYUNIT_HISTOGRAM_BUCKETS; idx++)
+    {
+        seen += histogram->counts[idx];
+        if (seen >= rank)
+        {
+            myunit_histogram_bounds(idx,&high);
+            break;
+        }
+    }
+    return (high < histogram->max) ? high : histogram->max;
+}
+
+/*!
+    \brief Prints a histogram.
+    \details Prints a `<HGS>` record with the number of values, the minimum, the 50th, 90th, 99th and 99.9th
+             percentile and the maximum, followed by a `<HGB>` record with the smallest value, the largest
+             value and the count of every bucket holding values, for the host to plot.
+    \param histogram The histogram.
+    \param name Name of the histogram in the records.
+*/
+void myunit_histogram_report(const myunit_histogram_t *histogram, const char *name)
+{
+    uint32_t idx, low, high;
+
+    MYUNIT_PRINTF("%s %s %s %s %u %u %u %u %u %u %u\n",myunit_histogram_summary_tag,myunit_testsuite_name,
+                  myunit_testcase_name,name,(unsigned)histogram->count,(unsigned)histogram->min,
+                  (unsigned)myunit_histogram_percentile(histogram,50.0),(unsigned)myunit_histogram_percentile(histogram,90.0),
+                  (unsigned)myunit_histogram_percentile(histogram,99.0),(unsigned)myunit_histogram_percentile(histogram,99.9),
+                  (unsigned)histogram->max);
+    for (idx = 0; idx < MYUNIT_HISTOGRAM_BUCKETS; idx++)
+    {
+        if (!histogram->counts[idx]) continue;
+        low = myunit_histogram_bounds(idx,&high);
+        MYUNIT_PRINTF("%s %s %s %s %u %u %u\n",myunit_histogram_bucket_tag,myunit_testsuite_name,myunit_testcase_name,
+                      name,(unsigned)low,(unsigned)high,(unsigned)histogram->counts[idx]);
+    }
+    (void)name;
+    (void)low;
+}
+
+
+/*!
+    \brief Records a value in a histogram, see `myunit_histogram_record`.
+*/
+#define MYUNIT_HISTOGRAM_RECORD(histogram,value) myunit_histogram_record(&(histogram),(value))
+
+/*!
+    \brief Prints the summary and the buckets of a histogram, see `myunit_histogram_report`.
+*/
+#define MYUNIT_HISTOGRAM_REPORT(histogram) myunit_histogram_report(&(histogram),#histogram)
+
+/*!
+    \brief Asserts that a percentile of a histogram is below a limit.
+    \details The percentile is computed once. On failure, the histogram is printed with `MYUNIT_HISTOGRAM_REPORT`
+             before the failure is reported, so the report is printed even if the failure aborts the test case.
+             The message of the assertion carries the observed percentile, e.g. "PERCENTILE 2047".
+    \param histogram The histogram.
+    \param percentile The percentile, e.g. 99.9.
+    \param limit The exclusive upper bound, in the unit of the recorded values.
+*/
+#define MYUNIT_ASSERT_PERCENTILE_BELOW(histogram,percentile,limit)                              \
+    do{                                                                                         \
+        const myunit_histogram_t *myunit_histogram = &(histogram);                              \
+        uint32_t myunit_observed = myunit_histogram_percentile(myunit_histogram,(percentile));  \
+        char myunit_message[32];                                                                \
+        if (myunit_observed >= (limit)) myunit_histogram_report(myunit_histogram,#histogram);   \
+        myunit_format(myunit_message,sizeof(myunit_message),"PERCENTILE %u",(unsigned)myunit_observed); \
+        MYUNIT_ASSERT(myunit_message,myunit_observed < (limit));                                \
+    }while(0)
+
+#endif /* MYUNIT_HISTOGRAM_H_ */
@@ -0,0 +1,274 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_mock.h                                              *
+ *  Description : Zero-allocation mocks recording their calls                *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_MOCK_H_
+#define MYUNIT_MOCK_H_
+
+#include "myunit.h"
+
+
+#ifndef MYUNIT_MOCK_HISTORY
+#define MYUNIT_MOCK_HISTORY 16 /*!< Calls recorded per mock, older calls are overwritten. Use a power of two. */
+#endif
+
+#ifndef MYUNIT_MOCK_RETURNS
+#define MYUNIT_MOCK_RETURNS 8 /*!< Return values which can be queued per mock. */
+#endif
+
+
+#define MYUNIT_MOCK_CAT_(a,b)       a##b
+#define MYUNIT_MOCK_CAT(a,b)        MYUNIT_MOCK_CAT_(a,b)
+#define MYUNIT_MOCK_UNPAREN_(...)   __VA_ARGS__
+#define MYUNIT_MOCK_UNPAREN(x)      MYUNIT_MOCK_UNPAREN_ x
+
+/*! Number of parameters of a mock declaration `ret, fn, t1, ..., tn`, up to 6. */
+#define MYUNIT_MOCK_PARAMS(...)     MYUNIT_MOCK_PARAMS_(__VA_ARGS__,6,5,4,3,2,1,0,-)
+#define MYUNIT_MOCK_PARAMS_(_1,_2,_3,_4,_5,_6,_7,_8,n,...) n
+
+/*!
+    \brief Signatures of mocks with 0 to 6 parameters.
+    \details Passes the pieces of the signature to the generator `M`: the parameter list, the argument list,
+             the parameters appended to other parameters, the fields recording the arguments, the statements
+             recording them in call `c` and the expression comparing call `c` to them. The parameters are
+             named `a1` to `a6`.
+*/
+#define MYUNIT_MOCK_ARITY_0(M,ret,fn) \
+    M(ret,fn,(void),(),(),(),(),(true))
+#define MYUNIT_MOCK_ARITY_1(M,ret,fn,t1) \
+    M(ret,fn,(t1 a1),(a1),(,t1 a1),(t1 a1;),(c->a1 = a1;),(c->a1 == a1))
+#define MYUNIT_MOCK_ARITY_2(M,ret,fn,t1,t2) \
+    M(ret,fn,(t1 a1,t2 a2),(a1,a2),(,t1 a1,t2 a2),(t1 a1; t2 a2;), \
+      (c->a1 = a1; c->a2 = a2;),(c->a1 == a1 && c->a2 == a2))
+#define MYUNIT_MOCK_ARITY_3(M,ret,fn,t1,t2,t3) \
+    M(ret,fn,(t1 a1,t2 a2,t3 a3),(a1,a2,a3),(,t1 a1,t2 a2,t3 a3),(t1 a1; t2 a2; t3 a3;), \
+      (c->a1 = a1; c->a2 = a2; c->a3 = a3;),(c->a1 == a1 && c->a2 == a2 && c->a3 == a3))
+#define MYUNIT_MOCK_ARITY_4(M,ret,fn,t1,t2,t3,t4) \
+    M(ret,fn,(t1 a1,t2 a2,t3 a3,t4 a4),(a1,a2,a3,a4),(,t1 a1,t2 a2,t3 a3,t4 a4),(t1 a1; t2 a2; t3 a3; t4 a4;), \
+      (c->a1 = a1; c->a2 = a2; c->a3 = a3; c->a4 = a4;), \
+      (c->a1 == a1 && c->a2 == a2 && c->a3 == a3 && c->a4 == a4))
+#define MYUNIT_MOCK_ARITY_5(M,ret,fn,t1,t2,t3,t4,t5) \
+    M(ret,fn,(t1 a1,t2 a2,t3 a3,t4 a4,t5 a5),(a1,a2,a3,a4,a5),(,t1 a1,t2 a2,t3 a3,t4 a4,t5 a5), \
+      (t1 a1; t2 a2; t3 a3; t4 a4; t5 a5;), \
+      (c->a1 = a1; c->a2 = a2; c->a3 = a3; c->a4 = a4; c->a5 = a5;), \
+      (c->a1 == a1 && c->a2 == a2 && c->a3 == a3 && c->a4 == a4 && c->a5 == a5))
+#define MYUNIT_MOCK_ARITY_6(M,ret,fn,t1,t2,t3,t4,t5,t6) \
+    M(ret,fn,(t1 a1,t2 a2,t3 a3,t4 a4,t5 a5,t6 a6),(a1,a2,a3,a4,a5,a6),(,t1 a1,t2 a2,t3 a3,t4 a4,t5 a5,t6 a6), \
+      (t1 a1; t2 a2; t3 a3; t4 a4; t5 a5; t6 a6;), \
+      (c->a1 = a1; c->a2 = a2; c->a3 = a3; c->a4 = a4; c->a5 = a5; c->a6 = a6;), \
+      (c->a1 == a1 && c->a2 == a2 && c->a3 == a3 && c->a4 == a4 && c->a5 == a5 && c->a6 == a6))
+
+
+/*!
+    \brief Parts shared by value and void mocks: the call record and its accessors.
+*/
+#define MYUNIT_MOCK_CALLS(fn,with_params,fields,compare)                                    \
+    typedef struct {                                                                        \
+        uint32_t sequence;                                                                  \
+        MYUNIT_MOCK_UNPAREN(fields)                                                         \
+    } myunit_mock_##fn##_call_t;                                                            \
+    const myunit_mock_##fn##_call_t *myunit_mock_##fn##_call(uint32_t n);                   \
+    bool myunit_mock_##fn##_with(uint32_t n MYUNIT_MOCK_UNPAREN(with_params))               \
+    {                                                                                       \
+        const myunit_mock_##fn##_call_t *c = myunit_mock_##fn##_call(n);                    \
+        return (c != NULL) && compare;                                                      \
+    }
+
+/*!
+    \brief Returns call `n` of a mock, or NULL if it was not made or is no longer recorded.
+*/
+#define MYUNIT_MOCK_CALL_ACCESSOR(fn)                                                       \
+    const myunit_mock_##fn##_call_t *myunit_mock_##fn##_call(uint32_t n)                    \
+    {                                                                                       \
+        if (n >= myunit_mock_##fn.count || myunit_mock_##fn.count - n > MYUNIT_MOCK_HISTORY) return NULL; \
+        return &myunit_mock_##fn.calls[n % MYUNIT_MOCK_HISTORY];                            \
+    }
+
+/*!
+    \brief Records a call of a mock in its history.
+*/
+#define MYUNIT_MOCK_RECORD(fn,store)                                                        \
+    myunit_mock_##fn##_call_t *c = &myunit_mock_##fn.calls[myunit_mock_##fn.count++ % MYUNIT_MOCK_HISTORY]; \
+    if (!myunit_mock_##fn.mock.listed) myunit_mock_register(&myunit_mock_##fn.mock);        \
+    c->sequence = myunit_mock_sequence++;                                                   \
+    MYUNIT_MOCK_UNPAREN(store)
+
+/*!
+    \brief Generates a mock returning a value.
+*/
+#define MYUNIT_MOCK_DEFINE(ret,fn,params,args,with_params,fields,store,compare)             \
+    MYUNIT_MOCK_CALLS(fn,with_params,fields,compare)                                        \
+    struct {                                                                                \
+        myunit_mock_t mock;                                                                 \
+        uint32_t count;                                                                     \
+        myunit_mock_##fn##_call_t calls[MYUNIT_MOCK_HISTORY];                               \
+        ret (*callback) params;                                                             \
+        ret value;                                                                          \
+        ret returns[MYUNIT_MOCK_RETURNS];                                                   \
+        uint32_t returns_head;                                                              \
+        uint32_t returns_count;                                                             \
+    } myunit_mock_##fn = {.mock = {.size = sizeof(myunit_mock_##fn)}};                      \
+    MYUNIT_MOCK_CALL_ACCESSOR(fn)                                                           \
+    ret fn params                                                                           \
+    {                                                                                       \
+        MYUNIT_MOCK_RECORD(fn,store)                                                        \
+        if (myunit_mock_##fn.callback) return myunit_mock_##fn.callback args;               \
+        if (myunit_mock_##fn.returns_count)                                                 \
+        {                                                                                   \
+            myunit_mock_##fn.returns_count--;                                               \
+            return myunit_mock_##fn.returns[myunit_mock_##fn.returns_head++ % MYUNIT_MOCK_RETURNS]; \
+        }                                                                                   \
+        return myunit_mock_##fn.value;                                                      \
+    }
+
+/*!
+    \brief Generates a mock without return value.
+*/
+#define MYUNIT_MOCK_DEFINE_VOID(ret,fn,params,args,with_params,fields,store,compare)        \
+    MYUNIT_MOCK_CALLS(fn,with_params,fields,compare)                                        \
+    struct {                                                                                \
+        myunit_mock_t mock;                                                                 \
+        uint32_t count;                                                                     \
+        myunit_mock_##fn##_call_t calls[MYUNIT_MOCK_HISTORY];                               \
+        void (*callback) params;                                                            \
+    } myunit_mock_##fn = {.mock = {.size = sizeof(myunit_mock_##fn)}};                      \
+    MYUNIT_MOCK_CALL_ACCESSOR(fn)                                                           \
+    void fn params                                                                          \
+    {                                                                                       \
+        MYUNIT_MOCK_RECORD(fn,store)                                                        \
+        if (myunit_mock_##fn.callback) myunit_mock_##fn.callback args;                      \
+    }
+
+
+/*!
+    \brief Defines a mock of the function `ret fn(t1, ..., tn)`.
+    \details Use as `MYUNIT_MOCK(ret, fn, t1, ..., tn)` with up to 6 parameter types, e.g.
+             `MYUNIT_MOCK(int, hal_spi_write, uint8_t, const uint8_t*, size_t)`. The mock defines `fn` itself,
+             so the test executable is linked against the mock instead of the real function. Each call is
+             recorded with its arguments, named `a1` to `an`, in a ring of the last `MYUNIT_MOCK_HISTORY` calls.
+             The mock returns, in order of precedence, the result of the callback set by
+             `MYUNIT_MOCK_CALLBACK`, the next value queued by `MYUNIT_MOCK_RETURN` or the value set by
+             `MYUNIT_MOCK_DEFAULT`, initially 0. All state lives in a static structure `myunit_mock_fn` and is
+             reset at the end of every test case.
+*/
+#define MYUNIT_MOCK(...) \
+    MYUNIT_MOCK_CAT(MYUNIT_MOCK_ARITY_,MYUNIT_MOCK_PARAMS(__VA_ARGS__))(MYUNIT_MOCK_DEFINE,__VA_ARGS__)
+
+/*!
+    \brief Defines a mock of the function `void fn(t1, ..., tn)`.
+    \details Use as `MYUNIT_MOCK_VOID(fn, t1, ..., tn)`, like `MYUNIT_MOCK` without return values.
+*/
+#define MYUNIT_MOCK_VOID(...) \
+    MYUNIT_MOCK_CAT(MYUNIT_MOCK_ARITY_,MYUNIT_MOCK_PARAMS(void,__VA_ARGS__))(MYUNIT_MOCK_DEFINE_VOID,void,__VA_ARGS__)
+
+
+/*!
+    \brief Number of calls of a mock in the running test case.
+*/
+#define MYUNIT_MOCK_COUNT(fn) (myunit_mock_##fn.count)
+
+/*!
+    \brief Call `n` of a mock, counted from 0, or NULL if it is no longer recorded.
+    \details The arguments of the call are the fields `a1` to `an`. The field `sequence` orders the calls of
+             all mocks in the running test case.
+*/
+#define MYUNIT_MOCK_CALL(fn,n) myunit_mock_##fn##_call(n)
+
+/*!
+    \brief Sets the value a mock returns when no callback is set and no value is queued.
+*/
+#define MYUNIT_MOCK_DEFAULT(fn,result) \
+    do{myunit_mock_register(&myunit_mock_##fn.mock); myunit_mock_##fn.value = (result);}while(0)
+
+/*!
+    \brief Sets a function called with the arguments of every call of a mock, whose result the mock returns.
+    \param function Function with the signature of the mocked function, NULL removes the callback.
+*/
+#define MYUNIT_MOCK_CALLBACK(fn,function) \
+    do{myunit_mock_register(&myunit_mock_##fn.mock); myunit_mock_##fn.callback = (function);}while(0)
+
+/*!
+    \brief Queues a value returned by one call of a mock.
+    \details Queued values are returned in order, one per call. Queueing more than `MYUNIT_MOCK_RETURNS`
+             values fails the test case.
+*/
+#define MYUNIT_MOCK_RETURN(fn,result)                                                           \
+    do{                                                                                         \
+        myunit_mock_register(&myunit_mock_##fn.mock);                                           \
+        if (myunit_mock_##fn.returns_count < MYUNIT_MOCK_RETURNS)                               \
+        {                                                                                       \
+            myunit_mock_##fn.returns[(myunit_mock_##fn.returns_head + myunit_mock_##fn.returns_count++) % MYUNIT_MOCK_RETURNS] = (result); \
+        }                                                                                       \
+        else                                                                                    \
+        {                                                                                       \
+            myunit_testcase_assert_fail_count++;                                                \
+            MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,__LINE__,"MOCK_RETURNS",#fn); \
+            MYUNIT_FAILURE_ACTION();                                                            \
+        }                                                                                       \
+    }while(0)
+
+/*!
+    \brief Resets a mock: clears its history, queued values, default value and callback.
+    \details Mocks are reset automatically at the end of every test case.
+*/
+#define MYUNIT_MOCK_RESET(fn) myunit_mock_reset(&myunit_mock_##fn.mock)
+
+
+/*!
+    \brief Asserts that a mock was called `n` times in the running test case.
+*/
+#define MYUNIT_ASSERT_CALLED(fn,n) \
+    MYUNIT_ASSERT("CALLED", MYUNIT_MOCK_COUNT(fn) == (n))
+
+/*!
+    \brief Asserts that a mock was not called in the running test case.
+*/
+#define MYUNIT_ASSERT_NOT_CALLED(fn) \
+    MYUNIT_ASSERT("NOT_CALLED", MYUNIT_MOCK_COUNT(fn) == 0)
+
+/*!
+    \brief Asserts that the last call of a mock had the given arguments.
+    \details Arguments are compared with `==`, pointers by address. Use `MYUNIT_MOCK_CALL` to check
+             the memory a pointer argument refers to.
+*/
+#define MYUNIT_ASSERT_CALLED_WITH(fn,...) \
+    MYUNIT_ASSERT("CALLED_WITH", myunit_mock_##fn##_with(MYUNIT_MOCK_COUNT(fn) - 1, __VA_ARGS__))
+
+/*!
+    \brief Asserts that call `n` of a mock, counted from 0, had the given arguments.
+    \details Fails if call `n` was not made or is no longer recorded.
+*/
+#define MYUNIT_ASSERT_NTH_CALLED_WITH(fn,n,...) \
+    MYUNIT_ASSERT("NTH_CALLED_WITH", myunit_mock_##fn##_with(n, __VA_ARGS__))
+
+#endif /* MYUNIT_MOCK_H_ */
@@ -33,9 +33,40 @@
  *     http://www.opensource.org/licenses/cpl1.0.txt
  */
 
+#define _GNU_SOURCE
+
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <link.h>
+#include <limits.h>
+
+
+uint64_t myunit_platform_clock(void)
+{
+    struct timespec now;
+
+    // CLOCK_MONOTONIC_RAW is left alone by the virtual clock interposer.
+    clock_gettime(CLOCK_MONOTONIC_RAW,&now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
 
+int myunit_platform_write(const char *buffer, size_t len)
+{
+    return (int)fwrite(buffer,1,len,stdout);
+}
 
 int myunit_platform_printf ( const char * format, ... )
 {
@@ -138,3 +169,546 @@ void myunit_platform_exception(void)
 
 
 
+
+static timer_t myunit_watchdog_timer;
+static bool myunit_watchdog_created = false;
+static void (*myunit_watchdog_expired)(void) = NULL;
+
+static void myunit_watchdog_handler(int signum)
+{
+    (void)signum;
+
+    // The callback leaves the handler by siglongjmp, which restores the signal
+    // mask saved by sigsetjmp, so SIGALRM is unblocked for the next test case.
+    if (myunit_watchdog_expired) myunit_watchdog_expired();
+}
+
+void myunit_platform_watchdog_start(uint32_t timeout, void (*expired)(void))
+{
+    struct sigaction action;
+    struct sigevent event;
+    struct itimerspec spec;
+
+    if (!myunit_watchdog_created)
+    {
+        memset(&action,0x00,sizeof(action));
+        action.sa_handler = myunit_watchdog_handler;
+        action.sa_flags = 0;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGALRM,&action,NULL);
+
+        memset(&event,0x00,sizeof(event));
+        event.sigev_notify = SIGEV_SIGNAL;
+        event.sigev_signo = SIGALRM;
+        if (timer_create(CLOCK_MONOTONIC,&event,&myunit_watchdog_timer) != 0) return;
+        myunit_watchdog_created = true;
+    }
+
+    myunit_watchdog_expired = expired;
+
+    memset(&spec,0x00,sizeof(spec));
+    spec.it_value.tv_sec = timeout / 1000;
+    spec.it_value.tv_nsec = (long)(timeout % 1000) * 1000000L;
+    timer_settime(myunit_watchdog_timer,0,&spec,NULL);
+}
+
+void myunit_platform_watchdog_stop(void)
+{
+    struct itimerspec spec;
+
+    if (!myunit_watchdog_created) return;
+
+    memset(&spec,0x00,sizeof(spec));
+    timer_settime(myunit_watchdog_timer,0,&spec,NULL);
+}
+
+uint32_t myunit_platform_parallel(unsigned workers, uint32_t (*work)(unsigned worker, unsigned workers))
+{
+    uint32_t result = 0;
+    uint32_t value;
+    unsigned worker;
+    int fds[2];
+
+    if (workers == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+
+    if (workers == 1 || pipe(fds) != 0) return work(0,1);
+
+    // Buffered output would be written again by every child.
+    fflush(stdout);
+
+    for (worker = 0; worker < workers; worker++)
+    {
+        pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            close(fds[0]);
+            value = work(worker,workers);
+            if (write(fds[1],&value,sizeof(value)) != sizeof(value)) _exit(EXIT_FAILURE);
+            _exit(EXIT_SUCCESS);
+        }
+
+        if (pid < 0)
+        {
+            // Out of processes, the remaining shares run in this process.
+            value = work(worker,workers);
+            if (value && (!result || value < result)) result = value;
+        }
+    }
+
+    close(fds[1]);
+
+    while (read(fds[0],&value,sizeof(value)) == sizeof(value))
+    {
+        if (value && (!result || value < result)) result = value;
+    }
+
+    close(fds[0]);
+    while (wait(NULL) > 0);
+
+    return result;
+}
+
+int myunit_platform_corpus(const char *path, void (*input)(const uint8_t *data, size_t size))
+{
+    struct dirent **entries;
+    char filename[4096];
+    int count;
+    int inputs = 0;
+    int idx;
+
+    count = scandir(path,&entries,NULL,alphasort);
+    if (count < 0) return -1;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        FILE *file;
+        uint8_t *data = NULL;
+        long size;
+
+        bool hidden = (entries[idx]->d_name[0] == '.');
+
+        snprintf(filename,sizeof(filename),"%s/%s",path,entries[idx]->d_name);
+        free(entries[idx]);
+
+        if (hidden || (file = fopen(filename,"rb")) == NULL) continue;
+
+        if (fseek(file,0,SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file,0,SEEK_SET) == 0)
+        {
+            // One spare byte, so an empty input still has a valid buffer.
+            data = (uint8_t*)malloc((size_t)size + 1);
+            if (data && fread(data,1,(size_t)size,file) == (size_t)size)
+            {
+                input(data,(size_t)size);
+                inputs++;
+            }
+            free(data);
+        }
+
+        fclose(file);
+    }
+
+    free(entries);
+    return inputs;
+}
+
+int myunit_platform_isolated(void (*run)(void), void *result, size_t size)
+{
+    size_t received = 0;
+    ssize_t count;
+    pid_t pid;
+    int fds[2];
+
+    if (pipe(fds) != 0) return 0;
+
+    // Buffered output would be written again by the child.
+    fflush(stdout);
+
+    pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return 0;
+    }
+
+    if (pid == 0)
+    {
+        // Timers are not inherited by fork, the child creates its own watchdog.
+        myunit_watchdog_created = false;
+        close(fds[0]);
+        run();
+        fflush(stdout);
+        if (write(fds[1],result,size) != (ssize_t)size) _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(fds[1]);
+    while (received < size && (count = read(fds[0],(uint8_t*)result + received,size - received)) > 0)
+    {
+        received += (size_t)count;
+    }
+    close(fds[0]);
+    waitpid(pid,NULL,0);
+
+    // A child which died before reporting crashed.
+    return (received == size) ? 1 : -1;
+}
+
+const char *myunit_platform_option(const char *name)
+{
+    return getenv(name);
+}
+
+void *myunit_platform_guarded_alloc(size_t size, bool left, size_t *guard)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t span = (size + page - 1) / page * page;
+    uint8_t *base;
+
+    base = mmap(NULL,span + 2 * page,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+    if (base == MAP_FAILED) return NULL;
+
+    if (mprotect(base,page,PROT_NONE) != 0 || mprotect(base + page + span,page,PROT_NONE) != 0)
+    {
+        munmap(base,span + 2 * page);
+        return NULL;
+    }
+
+    *guard = page;
+    return left ? base + page : base + page + span - size;
+}
+
+void myunit_platform_guarded_free(void *buffer, size_t size, bool left)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t span = (size + page - 1) / page * page;
+    uint8_t *base = left ? (uint8_t*)buffer - page : (uint8_t*)buffer + size - span - page;
+
+    munmap(base,span + 2 * page);
+}
+
+static void (*myunit_fault_callback)(void *address) = NULL;
+
+static void myunit_fault_signal(int signum, siginfo_t *info, void *context)
+{
+    (void)context;
+
+    // The callback leaves the handler by longjmp if it handles the fault, SA_NODEFER
+    // keeps the signal unblocked for the next fault.
+    if (myunit_fault_callback) myunit_fault_callback(info->si_addr);
+
+    // Not handled, the faulting access runs again and ends the process.
+    signal(signum,SIG_DFL);
+}
+
+void myunit_platform_fault_handler(void (*fault)(void *address))
+{
+    struct sigaction action;
+
+    myunit_fault_callback = fault;
+
+    memset(&action,0x00,sizeof(action));
+    action.sa_sigaction = myunit_fault_signal;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV,&action,NULL);
+    sigaction(SIGBUS,&action,NULL);
+}
+
+static pthread_t myunit_threads[256];
+static unsigned myunit_threads_count = 0;
+static pthread_barrier_t myunit_threads_barrier;
+static pthread_mutex_t myunit_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t myunit_threads_gate = PTHREAD_COND_INITIALIZER;
+static int myunit_threads_state;                    // 0 starting, 1 running, -1 start failed
+static void (*myunit_threads_run)(unsigned thread);
+static int myunit_threads_cpu[256];
+
+static void *myunit_threads_main(void *arg)
+{
+    unsigned thread = (unsigned)(uintptr_t)arg;
+    cpu_set_t cpus;
+    int state;
+
+    if (myunit_threads_cpu[thread] >= 0)
+    {
+        CPU_ZERO(&cpus);
+        CPU_SET(myunit_threads_cpu[thread],&cpus);
+        pthread_setaffinity_np(pthread_self(),sizeof(cpus),&cpus);
+    }
+
+    // Nobody may wait at the barrier before all threads exist.
+    pthread_mutex_lock(&myunit_threads_lock);
+    while ((state = myunit_threads_state) == 0) pthread_cond_wait(&myunit_threads_gate,&myunit_threads_lock);
+    pthread_mutex_unlock(&myunit_threads_lock);
+
+    if (state > 0) myunit_threads_run(thread);
+    return NULL;
+}
+
+void myunit_platform_threads_barrier(void)
+{
+    pthread_barrier_wait(&myunit_threads_barrier);
+}
+
+void myunit_platform_threads_join(void)
+{
+    unsigned thread;
+
+    for (thread = 0; thread < myunit_threads_count; thread++) pthread_join(myunit_threads[thread],NULL);
+    myunit_threads_count = 0;
+    pthread_barrier_destroy(&myunit_threads_barrier);
+}
+
+bool myunit_platform_threads_start(unsigned threads, void (*run)(unsigned thread))
+{
+    cpu_set_t allowed;
+    sigset_t alarm, mask;
+    unsigned started;
+    int cpus = 0;
+    int cpu;
+
+    if (threads == 0 || threads > sizeof(myunit_threads) / sizeof(myunit_threads[0])) return false;
+
+    // Distinct processors out of those the test process may use, reused round robin.
+    if (sched_getaffinity(0,sizeof(allowed),&allowed) != 0) CPU_ZERO(&allowed);
+    for (cpu = 0; cpu < CPU_SETSIZE && cpus < (int)threads; cpu++)
+    {
+        if (CPU_ISSET(cpu,&allowed)) myunit_threads_cpu[cpus++] = cpu;
+    }
+    for (started = 0; started < threads; started++)
+    {
+        myunit_threads_cpu[started] = cpus ? myunit_threads_cpu[started % (unsigned)cpus] : -1;
+    }
+
+    if (pthread_barrier_init(&myunit_threads_barrier,NULL,threads + 1) != 0) return false;
+
+    myunit_threads_run = run;
+    myunit_threads_state = 0;
+
+    // The workers inherit a signal mask blocking SIGALRM, so the watchdog always
+    // interrupts the thread running the test case.
+    sigemptyset(&alarm);
+    sigaddset(&alarm,SIGALRM);
+    pthread_sigmask(SIG_BLOCK,&alarm,&mask);
+    for (started = 0; started < threads; started++)
+    {
+        if (pthread_create(&myunit_threads[started],NULL,myunit_threads_main,(void*)(uintptr_t)started) != 0) break;
+    }
+    pthread_sigmask(SIG_SETMASK,&mask,NULL);
+
+    pthread_mutex_lock(&myunit_threads_lock);
+    myunit_threads_state = (started == threads) ? 1 : -1;
+    pthread_cond_broadcast(&myunit_threads_gate);
+    pthread_mutex_unlock(&myunit_threads_lock);
+
+    myunit_threads_count = started;
+    if (started == threads) return true;
+
+    myunit_platform_threads_join();
+    return false;
+}
+
+size_t myunit_platform_load(const char *name, void *buffer, size_t size, size_t offset)
+{
+    FILE *file = fopen(name,"rb");
+    size_t count = 0;
+
+    if (!file) return 0;
+    if (fseek(file,(long)offset,SEEK_SET) == 0) count = fread(buffer,1,size,file);
+    fclose(file);
+    return count;
+}
+
+bool myunit_platform_store(const char *name, const void *data, size_t size, bool append)
+{
+    char temp[PATH_MAX];
+    FILE *file;
+    bool written;
+
+    if (append)
+    {
+        file = fopen(name,"ab");
+        if (!file) return false;
+        written = (fwrite(data,1,size,file) == size);
+        return (fclose(file) == 0) && written;
+    }
+
+    // Replace the data by renaming a complete copy over it, so a concurrent
+    // test process reads either the old or the new data.
+    if (snprintf(temp,sizeof(temp),"%s.%ld.tmp",name,(long)getpid()) >= (int)sizeof(temp)) return false;
+    file = fopen(temp,"wb");
+    if (!file) return false;
+    written = (fwrite(data,1,size,file) == size);
+    written = (fclose(file) == 0) && written;
+    if (written && rename(temp,name) == 0) return true;
+    remove(temp);
+    return false;
+}
+
+void myunit_platform_delay(uint32_t us)
+{
+    struct timespec delay = {(time_t)(us / 1000000u), (long)(us % 1000000u) * 1000L};
+
+    // clock_nanosleep is not interposed by the virtual clock.
+    while (clock_nanosleep(CLOCK_MONOTONIC,0,&delay,&delay) == EINTR);
+}
+
+/*
+ * Function tracing for change-impact test selection. Code compiled with
+ * -finstrument-functions calls __cyg_profile_func_enter on every function
+ * entry, which records the function in a table shared with the processes of
+ * isolated test cases. myunit_platform_trace_end resolves the functions to
+ * their source files with addr2line, so the code under test needs debug
+ * information and must be linked into the test suite executable.
+ */
+#ifndef MYUNIT_PLATFORM_TRACE_FUNCTIONS
+#define MYUNIT_PLATFORM_TRACE_FUNCTIONS 4096
+#endif
+
+typedef struct {
+    volatile int active;                                // Functions are recorded
+    volatile int overflow;                              // A function did not fit into the table
+    void *functions[MYUNIT_PLATFORM_TRACE_FUNCTIONS];   // Open addressing hash set of the functions entered
+} myunit_trace_t;
+
+static myunit_trace_t *myunit_trace = NULL;
+
+void __cyg_profile_func_enter(void *function, void *site) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void *function, void *site) __attribute__((no_instrument_function));
+
+void __cyg_profile_func_enter(void *function, void *site)
+{
+    size_t idx, probe;
+
+    (void)site;
+    if (!myunit_trace || !myunit_trace->active) return;
+
+    idx = ((uintptr_t)function >> 4) % MYUNIT_PLATFORM_TRACE_FUNCTIONS;
+    for (probe = 0; probe < MYUNIT_PLATFORM_TRACE_FUNCTIONS; probe++)
+    {
+        void *expected = NULL;
+
+        if (__atomic_load_n(&myunit_trace->functions[idx],__ATOMIC_RELAXED) == function) return;
+        if (__atomic_compare_exchange_n(&myunit_trace->functions[idx],&expected,function,false,
+                                        __ATOMIC_RELAXED,__ATOMIC_RELAXED) || expected == function) return;
+        idx = (idx + 1) % MYUNIT_PLATFORM_TRACE_FUNCTIONS;
+    }
+    myunit_trace->overflow = 1;
+}
+
+void __cyg_profile_func_exit(void *function, void *site)
+{
+    (void)function;
+    (void)site;
+}
+
+void myunit_platform_trace_begin(void)
+{
+    if (!myunit_trace)
+    {
+        void *table = mmap(NULL,sizeof(myunit_trace_t),PROT_READ | PROT_WRITE,MAP_SHARED | MAP_ANONYMOUS,-1,0);
+        if (table == MAP_FAILED) return;
+        myunit_trace = table;
+    }
+    memset(myunit_trace,0,sizeof(myunit_trace_t));
+    myunit_trace->active = 1;
+}
+
+static int myunit_trace_bias(struct dl_phdr_info *info, size_t size, void *bias)
+{
+    (void)size;
+    // The executable comes first, its load bias turns run time addresses into addresses of the file.
+    *(uintptr_t *)bias = (uintptr_t)info->dlpi_addr;
+    return 1;
+}
+
+// Appends `file` to the space separated `files` unless it is listed already.
+static size_t myunit_trace_add(char *files, size_t len, size_t size, const char *file, size_t file_len)
+{
+    const char *entry = files;
+
+    while (entry < files + len)
+    {
+        size_t entry_len = strcspn(entry," ");
+        if (entry_len == file_len && !strncmp(entry,file,file_len)) return len;
+        entry += entry_len + 1;
+    }
+    if (len + file_len + 2 > size) return (size_t)-1;
+    if (len) files[len++] = ' ';
+    memcpy(files + len,file,file_len);
+    len += file_len;
+    files[len] = 0;
+    return len;
+}
+
+size_t myunit_platform_trace_end(char *files, size_t size)
+{
+    char exe[512], list[] = "/tmp/myunit_traceXXXXXX", command[1200], line[1024];
+    uintptr_t bias = 0;
+    ssize_t exe_len;
+    size_t idx, len = 0;
+    FILE *addresses, *resolved;
+    int fd;
+
+    if (size < 2) return 0;
+    files[0] = 0;
+    if (!myunit_trace) goto unknown;
+    myunit_trace->active = 0;
+    if (myunit_trace->overflow) goto unknown;
+
+    exe_len = readlink("/proc/self/exe",exe,sizeof(exe) - 1);
+    if (exe_len <= 0 || (size_t)exe_len >= sizeof(exe) - 1) goto unknown;
+    exe[exe_len] = 0;
+    dl_iterate_phdr(myunit_trace_bias,&bias);
+
+    if ((fd = mkstemp(list)) < 0) goto unknown;
+    if (!(addresses = fdopen(fd,"w")))
+    {
+        close(fd);
+        unlink(list);
+        goto unknown;
+    }
+    for (idx = 0; idx < MYUNIT_PLATFORM_TRACE_FUNCTIONS; idx++)
+    {
+        if (myunit_trace->functions[idx]) fprintf(addresses,"%lx\n",(unsigned long)((uintptr_t)myunit_trace->functions[idx] - bias));
+    }
+    fclose(addresses);
+
+    snprintf(command,sizeof(command),"addr2line -e '%s' < '%s'",exe,list);
+    resolved = popen(command,"r");
+    if (!resolved)
+    {
+        unlink(list);
+        goto unknown;
+    }
+    while (fgets(line,sizeof(line),resolved))
+    {
+        // Lines are file:line, optionally followed by " (discriminator n)", or ??:? if unknown. A function
+        // without a source file makes the whole list unknown, a change to it would go unnoticed otherwise.
+        char *colon;
+
+        line[strcspn(line," \n")] = 0;
+        if (!(colon = strrchr(line,':')) || colon == line || !strncmp(line,"??",2))
+        {
+            len = (size_t)-1;
+            break;
+        }
+        len = myunit_trace_add(files,len,size,line,(size_t)(colon - line));
+        if (len == (size_t)-1) break;
+    }
+    if (pclose(resolved) != 0) len = (size_t)-1;
+    unlink(list);
+    if (len != (size_t)-1) return len;
+
+unknown:
+    // Without the functions, the test case has to be considered affected by any change.
+    files[0] = '*';
+    files[1] = 0;
+    return 1;
+}
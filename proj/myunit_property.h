@@ -0,0 +1,463 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_property.h                                          *
+ *  Description : Property-based testing with shrinking                      *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_PROPERTY_H_
+#define MYUNIT_PROPERTY_H_
+
+#include "myunit.h"
+
+
+#ifndef MYUNIT_PROPERTY_MAX_DRAWS
+#define MYUNIT_PROPERTY_MAX_DRAWS 256 /*!< Number of random draws recorded per iteration, inputs with more draws are not shrunk. */
+#endif
+
+#ifndef MYUNIT_PROPERTY_SHRINK_LIMIT
+#define MYUNIT_PROPERTY_SHRINK_LIMIT 1000 /*!< Maximum number of property runs spent on shrinking a counterexample. */
+#endif
+
+#ifndef MYUNIT_PROPERTY_SEED
+#define MYUNIT_PROPERTY_SEED 0x6D79756EUL /*!< Base seed of the iteration seeds. */
+#endif
+
+#ifndef MYUNIT_PROPERTY_WORKERS
+#define MYUNIT_PROPERTY_WORKERS 1 /*!< Number of workers the iterations are spread over, 0 uses all processors. */
+#endif
+
+/*!
+    \def MYUNIT_PROPERTY_REPLAY
+    \brief Replays a reported failure.
+    \details If defined to the seed of a `<PRF>` record, every property runs exactly one iteration with this
+             seed instead of its generated iterations.
+*/
+
+#define myunit_property_failure_tag     "<PRF>" /*!< Tag reporting the seed of a failed property */
+#define myunit_property_log_tag         "<PRL>" /*!< Tag of values logged for a counterexample */
+
+
+/*!
+    \brief State of the running property.
+    \details Every value a property generates is derived from one 32-bit draw. While generating, draws come
+             from the xoshiro128** generator and are recorded. While shrinking, the recorded draws are
+             modified and replayed, draws past the end of the recording read as zero. Generators map
+             smaller draws to simpler values, so shrinking the draws shrinks the counterexample. An iteration
+             with more draws than `MYUNIT_PROPERTY_MAX_DRAWS` cannot be replayed and is reported unshrunk.
+*/
+typedef struct {
+    uint32_t rng[4];                                /*!< xoshiro128** state */
+    uint32_t draws[MYUNIT_PROPERTY_MAX_DRAWS];      /*!< Recorded draws of the current iteration */
+    uint32_t ndraws;                                /*!< Number of valid entries in draws */
+    uint32_t pos;                                   /*!< Index of the next draw */
+    bool overflow;                                  /*!< The generated iteration had more draws than recorded */
+    bool replay;                                    /*!< Draws are read from the recording */
+    bool report;                                    /*!< Final run of the shrunk counterexample */
+    bool failed;                                    /*!< A property assertion failed in the current run */
+    int fail_line;                                  /*!< Line of the failed property assertion */
+    const char *fail_message;                       /*!< Message of the failed property assertion */
+    const char *fail_test;                          /*!< Condition of the failed property assertion */
+} myunit_property_t;
+
+myunit_property_t myunit_property;                  /*!< State of the running property */
+uint32_t myunit_property_seed = MYUNIT_PROPERTY_SEED; /*!< Base seed, see MYUNIT_SET_PROPERTY_SEED */
+void (*myunit_property_body)(void);                 /*!< Body of the running property */
+uint32_t myunit_property_iterations;                /*!< Iterations of the running property */
+
+
+/*!
+    \brief Sets the base seed of the properties.
+    \details The seed of each iteration is derived from the base seed and the iteration index. Setting the
+             base seed to a different value explores different inputs with the same iteration count.
+    \param seed The new base seed.
+*/
+#define MYUNIT_SET_PROPERTY_SEED(seed) do{myunit_property_seed=(seed);}while(0)
+
+
+/*!
+    \brief Returns the seed of iteration `iteration`.
+    \details Also depends on the seed of the test case, so every repetition of a repeated test case
+             explores different inputs.
+*/
+uint32_t myunit_property_iteration_seed(uint32_t iteration)
+{
+    return myunit_seed_mix(myunit_property_seed ^ myunit_testcase_seed ^ myunit_seed_mix(iteration));
+}
+
+/*!
+    \brief Returns the next output of the xoshiro128** generator.
+*/
+uint32_t myunit_property_next(void)
+{
+    uint32_t *s = myunit_property.rng;
+    uint32_t result = s[1] * 5;
+    uint32_t t = s[1] << 9;
+
+    result = ((result << 7) | (result >> 25)) * 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+
+    return result;
+}
+
+/*!
+    \brief Returns the next draw of the running property.
+    \details All generators are built on this function.
+*/
+uint32_t myunit_property_draw(void)
+{
+    uint32_t pos = myunit_property.pos++;
+    uint32_t value;
+
+    if (myunit_property.replay)
+    {
+        return (pos < myunit_property.ndraws) ? myunit_property.draws[pos] : 0;
+    }
+
+    value = myunit_property_next();
+    if (pos < MYUNIT_PROPERTY_MAX_DRAWS) myunit_property.draws[pos] = value;
+    return value;
+}
+
+/*!
+    \brief Replaces the last draw by the value a generator actually used.
+    \details Generators which only use part of a draw store the reduced draw, so shrinking works on values
+             which map to outputs monotonically.
+*/
+void myunit_property_settle(uint32_t value)
+{
+    uint32_t pos = myunit_property.pos - 1;
+
+    if (pos < ((myunit_property.replay) ? myunit_property.ndraws : MYUNIT_PROPERTY_MAX_DRAWS))
+    {
+        myunit_property.draws[pos] = value;
+    }
+}
+
+
+/*!
+    \brief Generates an arbitrary 32-bit unsigned integer, shrinking towards 0.
+*/
+#define MYUNIT_GEN_UINT32() myunit_property_draw()
+
+/*!
+    \brief Generates an arbitrary 64-bit unsigned integer from two draws, shrinking towards 0.
+*/
+#define MYUNIT_GEN_UINT64() ((((uint64_t)myunit_property_draw()) << 32) | myunit_property_draw())
+
+/*!
+    \brief Generates a boolean, shrinking towards `false`.
+*/
+#define MYUNIT_GEN_BOOL() myunit_property_gen_bool()
+
+/*!
+    \brief Generates an integer in the range `min` to `max`, inclusive, shrinking towards `min`.
+    \param min The smallest value, at least INT32_MIN.
+    \param max The largest value, at most INT32_MAX.
+*/
+#define MYUNIT_GEN_INT(min,max) myunit_property_gen_int(min,max)
+
+/*!
+    \brief Fills `size` bytes at `buf` with arbitrary values, each byte shrinking towards 0.
+    \details Every four bytes consume one draw. Use it for buffers and for structures of plain data.
+*/
+#define MYUNIT_GEN_BYTES(buf,size) myunit_property_gen_bytes(buf,size)
+
+/*!
+    \brief Fills the structure `ptr` points to with arbitrary bytes.
+*/
+#define MYUNIT_GEN_STRUCT(ptr) myunit_property_gen_bytes(ptr,sizeof(*(ptr)))
+
+bool myunit_property_gen_bool(void)
+{
+    uint32_t draw = myunit_property_draw() & 1;
+
+    myunit_property_settle(draw);
+    return (bool)draw;
+}
+
+int32_t myunit_property_gen_int(int32_t min, int32_t max)
+{
+    uint32_t span = (uint32_t)max - (uint32_t)min + 1;
+    uint32_t draw = myunit_property_draw();
+
+    if (span) draw %= span;
+    myunit_property_settle(draw);
+    return (int32_t)((uint32_t)min + draw);
+}
+
+void myunit_property_gen_bytes(void *buf, size_t size)
+{
+    uint8_t *bytes = (uint8_t*)buf;
+
+    while (size)
+    {
+        size_t len = (size < 4) ? size : 4, idx;
+        uint32_t draw = myunit_property_draw();
+
+        if (len < 4) draw &= (1UL << (8 * len)) - 1;
+        myunit_property_settle(draw);
+        for (idx = 0; idx < len; idx++) *bytes++ = (uint8_t)(draw >> (8 * idx));
+        size -= len;
+    }
+}
+
+
+/*!
+    \brief Checks a condition of a property.
+    \details Must be used instead of `MYUNIT_ASSERT` inside a property body, which runs many times while
+             generating and shrinking. The first failing check ends the current run of the body.
+    \param message A custom message associated with the check.
+    \param test The condition which must hold for every input.
+*/
+#define MYUNIT_PROPERTY_ASSERT(message,test)                        \
+    do{                                                             \
+        MYUNIT_INVENTORY_SITE();                                    \
+        if (!(test))                                                \
+        {                                                           \
+            myunit_property.failed = true;                          \
+            myunit_property.fail_line = __LINE__;                   \
+            myunit_property.fail_message = message;                 \
+            myunit_property.fail_test = #test;                      \
+            return;                                                 \
+        }                                                           \
+    }while(0)
+
+/*!
+    \brief Logs values of the shrunk counterexample.
+    \details Does nothing while generating and shrinking. Only the final run of the minimal counterexample
+             prints, prefixed by `<PRL>`, the test suite and the test case name.
+    \param ... A `printf`-style format string and its arguments, terminated by a newline.
+*/
+#define MYUNIT_PROPERTY_LOG(...)                                                            \
+    do{                                                                                     \
+        if (myunit_property.report)                                                         \
+        {                                                                                   \
+            MYUNIT_PRINTF("%s %s %s ",myunit_property_log_tag,myunit_testsuite_name,myunit_testcase_name); \
+            MYUNIT_PRINTF(__VA_ARGS__);                                                     \
+        }                                                                                   \
+    }while(0)
+
+
+/*!
+    \brief Defines a property-based test case.
+    \details The body following the macro is run with fresh inputs `iterations` times. It draws its inputs from
+             the `MYUNIT_GEN_*` generators and checks them with `MYUNIT_PROPERTY_ASSERT`. Execute the test case
+             with `MYUNIT_EXEC_TESTCASE(name)`. The whole property counts as one assertion.
+    \param name The name of the test case.
+    \param iterations The number of generated inputs.
+*/
+#define MYUNIT_PROPERTY(name,iterations)                                    \
+    void myunit_property_##name(void);                                      \
+    MYUNIT_TESTCASE(name)                                                   \
+    {                                                                       \
+        myunit_property_run(myunit_property_##name,iterations,__LINE__);    \
+    }                                                                       \
+    void myunit_property_##name(void)
+
+
+/*!
+    \brief Runs the property body once.
+    \param replay `true` to replay the recorded draws, `false` to generate new draws from `seed`.
+    \param seed The seed of the generator, unused when replaying.
+    \return `true` if the property failed.
+*/
+bool myunit_property_once(bool replay, uint32_t seed)
+{
+    uint32_t idx;
+
+    if (!replay)
+    {
+        for (idx = 0; idx < 4; idx++)
+        {
+            seed = myunit_seed_mix(seed);
+            myunit_property.rng[idx] = seed;
+        }
+    }
+
+    myunit_property.replay = replay;
+    myunit_property.failed = false;
+    myunit_property.fail_line = 0;
+    myunit_property.fail_message = NULL;
+    myunit_property.fail_test = NULL;
+    myunit_property.pos = 0;
+    myunit_property_body();
+
+    if (!replay)
+    {
+        myunit_property.overflow = myunit_property.pos > MYUNIT_PROPERTY_MAX_DRAWS;
+        myunit_property.ndraws = (myunit_property.pos < MYUNIT_PROPERTY_MAX_DRAWS) ? myunit_property.pos : MYUNIT_PROPERTY_MAX_DRAWS;
+    }
+
+    return myunit_property.failed;
+}
+
+/*!
+    \brief Generates the iterations of one worker.
+    \return One more than the index of the first failing iteration, 0 if all iterations passed.
+*/
+uint32_t myunit_property_work(unsigned worker, unsigned workers)
+{
+    uint32_t iteration;
+
+    for (iteration = worker; iteration < myunit_property_iterations; iteration += workers)
+    {
+        if (myunit_property_once(false,myunit_property_iteration_seed(iteration))) return iteration + 1;
+    }
+
+    return 0;
+}
+
+/*!
+    \brief Shrinks the recorded draws of a failing iteration.
+    \details Greedy search over the draws: the recording is truncated, then each draw is set to zero or
+             reduced by bisection, keeping every change which still fails the property. Runs until no change
+             helps or `MYUNIT_PROPERTY_SHRINK_LIMIT` runs are spent.
+    \return The number of successful shrink steps.
+*/
+uint32_t myunit_property_shrink(void)
+{
+    uint32_t runs = 0;
+    uint32_t steps = 0;
+    bool improved = true;
+
+    while (improved && runs < MYUNIT_PROPERTY_SHRINK_LIMIT)
+    {
+        uint32_t idx;
+
+        improved = false;
+
+        // Drop trailing draws, they read as zero.
+        while (myunit_property.ndraws && runs < MYUNIT_PROPERTY_SHRINK_LIMIT)
+        {
+            uint32_t ndraws = myunit_property.ndraws;
+
+            myunit_property.ndraws = ndraws / 2;
+            runs++;
+            if (myunit_property_once(true,0)) { steps++; improved = true; continue; }
+            myunit_property.ndraws = ndraws;
+            break;
+        }
+
+        for (idx = 0; idx < myunit_property.ndraws && runs < MYUNIT_PROPERTY_SHRINK_LIMIT; idx++)
+        {
+            uint32_t value = myunit_property.draws[idx];
+            uint32_t lo = 0;
+            uint32_t hi = value;
+
+            // Find the smallest value of this draw which still fails.
+            while (lo < hi && runs < MYUNIT_PROPERTY_SHRINK_LIMIT)
+            {
+                uint32_t mid = lo + (hi - lo) / 2;
+
+                myunit_property.draws[idx] = mid;
+                runs++;
+                if (myunit_property_once(true,0)) hi = mid;
+                else lo = mid + 1;
+            }
+
+            myunit_property.draws[idx] = hi;
+            if (hi != value) { steps++; improved = true; }
+        }
+    }
+
+    return steps;
+}
+
+/*!
+    \brief Runs a property and records its result as one assertion.
+    \details Iterations are spread over `MYUNIT_PROPERTY_WORKERS` workers with `myunit_platform_parallel`. The
+             first failing iteration is regenerated and shrunk in the test case. The minimal counterexample is
+             run once more with `MYUNIT_PROPERTY_LOG` enabled, then reported by a failed assertion on the line
+             of the failing `MYUNIT_PROPERTY_ASSERT` and a `<PRF>` record with the iteration seed. An iteration
+             with more draws than `MYUNIT_PROPERTY_MAX_DRAWS` is regenerated instead of shrunk, its `<PRF>`
+             record ends with `UNSHRUNK`. If the final run passes, the failure is reported on the line of the
+             property with the message "not reproduced".
+    \param body The property body.
+    \param iterations The number of generated inputs.
+    \param line The line of the property definition, reported if the property holds.
+*/
+void myunit_property_run(void (*body)(void), uint32_t iterations, int line)
+{
+    uint32_t first;
+    uint32_t seed;
+    uint32_t steps;
+    bool overflow;
+
+    myunit_property_body = body;
+    myunit_property_iterations = iterations;
+    myunit_property.report = false;
+
+#ifdef MYUNIT_PROPERTY_REPLAY
+    first = myunit_property_once(false,MYUNIT_PROPERTY_REPLAY) ? 1 : 0;
+    seed = MYUNIT_PROPERTY_REPLAY;
+#else
+    first = myunit_platform_parallel(MYUNIT_PROPERTY_WORKERS,myunit_property_work);
+    seed = myunit_property_iteration_seed(first - 1);
+#endif
+
+    if (!first)
+    {
+        myunit_testcase_assert_success_count++;
+        myunit_testcase_last_line = line;
+        MYUNIT_REPORT_PASSED_PRINTF(myunit_testcase_passed_tag,line,"PROPERTY","holds");
+        return;
+    }
+
+    myunit_property_once(false,seed);
+    overflow = myunit_property.overflow;
+    steps = overflow ? 0 : myunit_property_shrink();
+
+    // Without a complete recording, only the generator reproduces the input.
+    myunit_property.report = true;
+    myunit_property_once(!overflow,seed);
+    myunit_property.report = false;
+
+    myunit_testcase_assert_fail_count++;
+    if (myunit_property.failed)
+    {
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,myunit_property.fail_line,myunit_property.fail_message,myunit_property.fail_test);
+    }
+    else
+    {
+        MYUNIT_REPORT_FAILED_PRINTF(myunit_testcase_failure_tag,line,"PROPERTY","not reproduced");
+    }
+    MYUNIT_PRINTF("%s %s %s %u %u %u%s\n",myunit_property_failure_tag,myunit_testsuite_name,myunit_testcase_name,
+                  (unsigned)seed,(unsigned)(first - 1),(unsigned)steps,overflow ? " UNSHRUNK" : "");
+    MYUNIT_FAILURE_ACTION();
+}
+
+#endif /* MYUNIT_PROPERTY_H_ */
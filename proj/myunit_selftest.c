@@ -32,7 +32,22 @@
  * or can be found online at:
  *     http://www.opensource.org/licenses/cpl1.0.txt
  */
+// Print at most three passed and three failed results per assertion and test case.
+#define MYUNIT_ASSERT_AGGREGATE 3
+#define MYUNIT_BASELINE
+#define MYUNIT_HISTORY
+#define MYUNIT_HISTORY_FAILED_FIRST
+#define MYUNIT_COVERAGE
+#define MYUNIT_SERIAL
+#define MYUNIT_ARENA
+
 #include "myunit.h"
+#include "myunit_property.h"
+#include "myunit_fuzz.h"
+#include "myunit_mock.h"
+#include "myunit_async.h"
+#include "myunit_concurrent.h"
+#include "myunit_histogram.h"
 
 
 MYUNIT_TESTCASE(test_assert)
@@ -313,6 +328,539 @@ MYUNIT_TESTCASE(test_sequence) {
 
 }
 
+MYUNIT_TESTCASE(test_timeout) {
+
+    volatile bool register_ready = false;
+
+    MYUNIT_ASSERT_FALSE(register_ready);
+
+    // Polls a flag which never flips, the watchdog aborts the test case and
+    // reports a timeout on the line of the assertion above.
+    while (!register_ready);
+
+    MYUNIT_ASSERT_TRUE(register_ready);
+}
+
+static int virtual_timer_fired = 0;
+
+static void virtual_timer_callback(void *arg) {
+    virtual_timer_fired = *(int*)arg;
+}
+
+MYUNIT_TESTCASE(test_virtual_time) {
+
+    static int timer_arg = 42;
+
+    MYUNIT_VIRTUAL_TIME_BEGIN();
+
+    // Virtual time starts at zero and only moves when advanced by the test.
+    MYUNIT_ASSERT_TRUE(myunit_platform_now() == 0);
+
+    MYUNIT_ASSERT_TRUE(MYUNIT_SCHEDULE_TIMER(1000000, virtual_timer_callback, &timer_arg) >= 0);
+
+    MYUNIT_ADVANCE_TIME(999999);
+    MYUNIT_ASSERT_EQUAL(virtual_timer_fired, 0);   // One nanosecond early, the timer has not fired yet
+
+    MYUNIT_ADVANCE_TIME(1);
+    MYUNIT_ASSERT_EQUAL(virtual_timer_fired, 42);  // Timer fired exactly on its deadline
+    MYUNIT_ASSERT_TRUE(myunit_platform_now() == 1000000);
+
+    MYUNIT_VIRTUAL_TIME_END();
+    MYUNIT_ASSERT_FALSE(myunit_vclock_enabled());
+}
+
+MYUNIT_PROPERTY(test_property_holds, 1000) {
+
+    // Passing property: reversing a buffer twice restores it.
+    uint8_t buffer[16];
+    uint8_t reversed[16];
+    size_t size = (size_t)MYUNIT_GEN_INT(0, sizeof(buffer));
+    size_t idx;
+
+    MYUNIT_GEN_BYTES(buffer, size);
+
+    for (idx = 0; idx < size; idx++) reversed[idx] = buffer[size - 1 - idx];
+    for (idx = 0; idx < size; idx++) MYUNIT_PROPERTY_ASSERT("Reverse twice", reversed[size - 1 - idx] == buffer[idx]);
+}
+
+MYUNIT_PROPERTY(test_property_fails, 1000) {
+
+    // Failing property: the sum of two values below 1000 stays below 1500.
+    // Shrinking reports a minimal counterexample, a + b == 1500.
+    int32_t a = MYUNIT_GEN_INT(0, 999);
+    int32_t b = MYUNIT_GEN_INT(0, 999);
+
+    MYUNIT_PROPERTY_LOG("a=%d b=%d\n", (int)a, (int)b);
+    MYUNIT_PROPERTY_ASSERT("Sum below 1500", a + b < 1500);
+}
+
+static uint8_t property_bytes[1000];
+static uint8_t property_bytes_generated[1000];
+
+static void property_bytes_body(void) {
+    MYUNIT_GEN_BYTES(property_bytes, sizeof(property_bytes));
+}
+
+MYUNIT_TESTCASE(test_property_bytes) {
+
+    // Test case description: 1000 bytes take 250 draws, so the recording is complete and replaying it
+    // reproduces every byte the generator made.
+    myunit_property_body = property_bytes_body;
+    myunit_property_once(false, 1234);
+    memcpy(property_bytes_generated, property_bytes, sizeof(property_bytes));
+    MYUNIT_ASSERT_EQUAL(myunit_property.ndraws, 250);
+    MYUNIT_ASSERT_FALSE(myunit_property.overflow);
+
+    memset(property_bytes, 0x00, sizeof(property_bytes));
+    myunit_property_once(true, 0);
+    MYUNIT_ASSERT_MEM_EQUAL(property_bytes, property_bytes_generated, sizeof(property_bytes));
+}
+
+// Code under test of the fuzz example: sums the values of type-length-value records.
+static int tlv_sum(const uint8_t *data, size_t size, size_t *consumed) {
+
+    size_t pos = 0;
+    size_t idx;
+    int sum = 0;
+
+    while (pos + 2 <= size) {
+        size_t len = data[pos + 1];
+        if (pos + 2 + len > size) break;
+        for (idx = 0; idx < len; idx++) sum += data[pos + 2 + idx];
+        pos += 2 + len;
+    }
+
+    *consumed = pos;
+    return sum;
+}
+
+MYUNIT_FUZZ_TESTCASE(test_fuzz_tlv, data, size) {
+
+    // Replays corpus/test_fuzz_tlv in the selftest, runs on fuzzer inputs in the fuzz builds.
+    size_t consumed;
+    int sum = tlv_sum(data, size, &consumed);
+
+    MYUNIT_ASSERT("Records within input", consumed <= size);
+    MYUNIT_ASSERT("Sum bounded by input", sum <= (int)size * 255);
+}
+
+typedef struct {
+    int a;
+    int b;
+    int sum;
+} add_vector_t;
+
+static const add_vector_t add_vectors[] = {
+    {  1,  2,  3 },
+    { -1,  1,  0 },
+    {  2,  2,  5 },     // Wrong expectation, reported as test_parameterized[2]
+    { 40,  2, 42 },
+};
+
+MYUNIT_TESTCASE_P(test_parameterized, add_vector_t, add_vectors) {
+
+    // Test case description: This test case is executed once for each row of add_vectors.
+    MYUNIT_ASSERT_EQUAL(param->a + param->b, param->sum);
+}
+
+MYUNIT_TESTCASE(test_assert_aggregate) {
+
+    // Test case description: An assertion evaluated for 1000 samples, of which the last 10 fail.
+    // Only the first three passed and failed results are printed, followed by one <TCA> summary.
+    // The counters in <TCE> include all 1000 results.
+    int sample;
+
+    for (sample = 0; sample < 1000; sample++) {
+        MYUNIT_ASSERT("Sample below 990", sample < 990);
+    }
+}
+
+MYUNIT_TESTCASE(test_repeat) {
+
+    // Test case description: Executed 50 times with a different seed each time. About one in eight
+    // seeds fails, so the <TCR> summary reports the test case as FLAKY along with the first failed seed.
+    MYUNIT_ASSERT("Seed not a multiple of 8", (MYUNIT_SEED() % 8) != 0);
+}
+
+// Mocks of a HAL used by the sensor driver below.
+MYUNIT_MOCK(int, hal_i2c_write, uint8_t, uint8_t, uint8_t);
+MYUNIT_MOCK(uint32_t, hal_tick);
+MYUNIT_MOCK_VOID(hal_delay, uint32_t);
+
+static int sensor_configure(uint8_t address)
+{
+    int retries;
+
+    for (retries = 0; retries < 3; retries++) {
+        if (hal_i2c_write(address, 0x20, 0x47) == 0) {
+            hal_delay(hal_tick() + 10);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void count_delay(uint32_t until)
+{
+    MYUNIT_CHECKPOINT_SET(until & 0x7F);
+}
+
+MYUNIT_TESTCASE(test_mock) {
+
+    // Test case description: The driver retries a failed write. The first write fails, the second succeeds.
+    MYUNIT_MOCK_RETURN(hal_i2c_write, -5);
+    MYUNIT_MOCK_DEFAULT(hal_tick, 100);
+    MYUNIT_MOCK_CALLBACK(hal_delay, count_delay);
+    MYUNIT_CHECKPOINS_INIT();
+
+    MYUNIT_ASSERT_EQUAL(sensor_configure(0x18), 0);
+
+    MYUNIT_ASSERT_CALLED(hal_i2c_write, 2);
+    MYUNIT_ASSERT_CALLED_WITH(hal_i2c_write, 0x18, 0x20, 0x47);
+    MYUNIT_ASSERT_CALLED_WITH(hal_delay, 110);
+    MYUNIT_ASSERT_CHECKPOINT_PASSED(110);
+    MYUNIT_ASSERT("Delay after tick", MYUNIT_MOCK_CALL(hal_delay, 0)->sequence > MYUNIT_MOCK_CALL(hal_tick, 0)->sequence);
+}
+
+// Peripherals completing their work in the background, advanced by the scheduler after every turn.
+static uint32_t uart_received;
+static uint32_t adc_conversions;
+
+static void peripherals_poll(void)
+{
+    uart_received++;
+    if (uart_received % 3 == 0) adc_conversions++;
+}
+
+MYUNIT_ASYNC_TESTCASE(test_async_uart) {
+
+    // Test case description: Waits for a frame of 8 bytes while test_async_adc waits for its conversions.
+    static uint32_t start;
+
+    MYUNIT_ASYNC_BEGIN();
+    start = uart_received;
+    MYUNIT_AWAIT(uart_received - start >= 8);
+    MYUNIT_ASSERT_EQUAL(uart_received - start, 8);
+    MYUNIT_ASYNC_END();
+}
+
+MYUNIT_ASYNC_TESTCASE(test_async_adc) {
+
+    // Test case description: Waits for two conversions, yielding once in between.
+    static uint32_t start;
+
+    MYUNIT_ASYNC_BEGIN();
+    start = adc_conversions;
+    MYUNIT_AWAIT(adc_conversions > start);
+    MYUNIT_ASSERT_EQUAL(adc_conversions - start, 1);
+    MYUNIT_YIELD();
+    MYUNIT_AWAIT(adc_conversions - start >= 2);
+    MYUNIT_ASSERT_EQUAL(adc_conversions - start, 2);
+    MYUNIT_ASYNC_END();
+}
+
+// Lock-free single producer single consumer ring buffer under test.
+#define RING_SIZE 64
+
+static uint32_t ring[RING_SIZE];
+static uint32_t ring_head;      // written by the producer only
+static uint32_t ring_tail;      // written by the consumer only
+static uint32_t ring_produced;
+static uint32_t ring_consumed;
+
+static bool ring_push(uint32_t value)
+{
+    uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+
+    if (head - __atomic_load_n(&ring_tail, __ATOMIC_ACQUIRE) == RING_SIZE) return false;
+    ring[head % RING_SIZE] = value;
+    __atomic_store_n(&ring_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool ring_pop(uint32_t *value)
+{
+    uint32_t tail = __atomic_load_n(&ring_tail, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&ring_head, __ATOMIC_ACQUIRE) == tail) return false;
+    *value = ring[tail % RING_SIZE];
+    __atomic_store_n(&ring_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool ring_consistent(void)
+{
+    return ring_head - ring_tail <= RING_SIZE && ring_produced - ring_consumed == ring_head - ring_tail;
+}
+
+MYUNIT_CONCURRENT_BODY(ring_stress) {
+
+    uint32_t value;
+
+    if (MYUNIT_THREAD() == 0) {
+        if (ring_push(ring_produced)) ring_produced++;
+    } else if (ring_pop(&value)) {
+        MYUNIT_CONCURRENT_ASSERT(value == ring_consumed);
+        ring_consumed++;
+    }
+}
+
+MYUNIT_TESTCASE(test_concurrent) {
+
+    // Test case description: A producer and a consumer thread stress the ring buffer in lockstep rounds,
+    // the ring buffer is checked for consistency after every round.
+    MYUNIT_SET_CONCURRENT_INVARIANT(ring_consistent);
+    MYUNIT_CONCURRENT(2, 100000, ring_stress);
+    MYUNIT_SET_CONCURRENT_INVARIANT(NULL);
+    MYUNIT_ASSERT_TRUE(ring_consumed > 0);
+}
+
+// Copies a string including its terminator if it fits, the bound check is off by one.
+static void copy_name(char *dest, size_t size, const char *name)
+{
+    size_t len = strlen(name);
+
+    if (len <= size) memcpy(dest, name, len + 1);
+}
+
+MYUNIT_TESTCASE(test_guard_overflow) {
+
+    // Test case description: copy_name writes one byte past the buffer for a name as long as the buffer,
+    // the write faults on the guard page right after the buffer.
+    char *name = MYUNIT_GUARDED_BUFFER(8);
+
+    MYUNIT_REQUIRE_NOT_NULL(name);
+    copy_name(name, 8, "sensor");
+    MYUNIT_ASSERT_MEM_EQUAL(name, "sensor", 7);
+    copy_name(name, 8, "sensor01");
+    MYUNIT_ASSERT_MEM_EQUAL(name, "sensor01", 8);
+}
+
+MYUNIT_TESTCASE(test_arena) {
+
+    // Test case description: Scratch buffers come from the arena and are given back after the test case.
+    uint32_t *samples = MYUNIT_ALLOC(64 * sizeof(uint32_t), sizeof(uint32_t));
+    uint8_t *frame = MYUNIT_ALLOC(100, 1);
+    uint64_t *stamps = MYUNIT_ALLOC(8 * sizeof(uint64_t), 8);
+    int idx;
+
+    for (idx = 0; idx < 64; idx++) samples[idx] = (uint32_t)idx;
+    memset(frame, 0x55, 100);
+    MYUNIT_ASSERT_EQUAL((uintptr_t)stamps % 8, 0);
+    MYUNIT_ASSERT_EQUAL(samples[63], 63);
+}
+
+MYUNIT_TESTCASE(test_arena_exhausted) {
+
+    // Test case description: The second buffer does not fit, the test case fails and is aborted before
+    // the buffer is used.
+    uint8_t *image = MYUNIT_ALLOC(MYUNIT_ARENA_SIZE / 2 + 1, 4);
+    uint8_t *copy = MYUNIT_ALLOC(MYUNIT_ARENA_SIZE / 2 + 1, 4);
+
+    memcpy(copy, image, MYUNIT_ARENA_SIZE / 2 + 1);
+}
+
+MYUNIT_TESTCASE(test_baseline_statistics) {
+
+    // Test case description: The durations of a run 20% slower than the baseline score far above the
+    // significance threshold, an unchanged run scores zero.
+    uint32_t base[32], slower[32];
+    int idx;
+
+    for (idx = 0; idx < 32; idx++) {
+        base[idx] = (uint32_t)(100 + idx);
+        slower[idx] = (uint32_t)(120 + idx);
+    }
+
+    MYUNIT_ASSERT_TRUE(myunit_baseline_z(base, 32, slower, 32) > MYUNIT_REGRESSION_Z);
+    MYUNIT_ASSERT_TRUE(myunit_baseline_z(slower, 32, base, 32) < -MYUNIT_REGRESSION_Z);
+    MYUNIT_ASSERT_TRUE(myunit_baseline_z(base, 32, base, 32) == 0);
+}
+
+MYUNIT_TESTCASE(test_format) {
+
+    // Test case description: The built-in formatter matches snprintf for the conversions it supports and
+    // truncates to the buffer like snprintf.
+    char buffer[64];
+    char short_buffer[8];
+
+    MYUNIT_ASSERT_TRUE(myunit_format(buffer, sizeof(buffer), "%s %d %u", "<TCE>", -42, 4000000000u) == 20);
+    MYUNIT_ASSERT_MEM_EQUAL(buffer, "<TCE> -42 4000000000", sizeof("<TCE> -42 4000000000"));
+    myunit_format(buffer, sizeof(buffer), "%ld %llu %zu %x", -1L, 18446744073709551615ULL, (size_t)7, 0xbeefu);
+    MYUNIT_ASSERT_MEM_EQUAL(buffer, "-1 18446744073709551615 7 beef", sizeof("-1 18446744073709551615 7 beef"));
+    myunit_format(buffer, sizeof(buffer), "[%04d] [%3u] %c %% %q", -7, 5u, 'x');
+    MYUNIT_ASSERT_MEM_EQUAL(buffer, "[-007] [  5] x % %q", sizeof("[-007] [  5] x % %q"));
+    MYUNIT_ASSERT_TRUE(myunit_format(short_buffer, sizeof(short_buffer), "%s", "truncated") == 9);
+    MYUNIT_ASSERT_MEM_EQUAL(short_buffer, "truncat", sizeof("truncat"));
+}
+
+// Code under test with coverage sites, the error branch is never reached by the test suite.
+static int command_length(char command)
+{
+    switch (command) {
+    case 'r':
+        MYUNIT_COVER();
+        return 1;
+    case 'w':
+        MYUNIT_COVER();
+        return 5;
+    default:
+        MYUNIT_COVER();
+        return -1;
+    }
+}
+
+MYUNIT_TESTCASE(test_cover) {
+
+    // Test case description: Reaches the coverage sites of the read and write commands, the report at the
+    // end of the test suite lists the site of unknown commands as unreached.
+    MYUNIT_ASSERT_EQUAL(command_length('r'), 1);
+    MYUNIT_ASSERT_EQUAL(command_length('w'), 5);
+}
+
+// Link state of a simulated modem, brought up by a timer of the virtual clock.
+static volatile bool link_up = false;
+
+static void link_up_callback(void *arg)
+{
+    (void)arg;
+    link_up = true;
+}
+
+MYUNIT_TESTCASE(test_eventually) {
+
+    // Test case description: The link comes up 5 ms after the connect, the assertion polls until it does
+    // instead of sleeping for a fixed time. Afterwards the link stays up for 20 ms.
+    link_up = false;
+    MYUNIT_VIRTUAL_TIME_BEGIN();
+    MYUNIT_SCHEDULE_TIMER(5000000, link_up_callback, NULL);
+
+    MYUNIT_ASSERT_EVENTUALLY(link_up, 50);
+    MYUNIT_ASSERT_TRUE(myunit_platform_now() < 10000000);  // The backoff overshoots by less than the time waited
+    MYUNIT_ASSERT_ALWAYS(link_up, 20);
+
+    MYUNIT_VIRTUAL_TIME_END();
+}
+
+MYUNIT_TESTCASE(test_eventually_timeout) {
+
+    // Test case description: Fails, nothing brings the link up within 10 ms of real time. The failure is
+    // followed by a <TCW> record with the elapsed time and the number of polls.
+    link_up = false;
+    MYUNIT_ASSERT_EVENTUALLY(link_up, 10);
+}
+
+// Interrupt response times of two simulated cores, recorded in histograms of their own.
+static myunit_histogram_t irq_latency;
+static myunit_histogram_t irq_latency_core1;
+
+MYUNIT_TESTCASE(test_histogram) {
+
+    // Test case description: 10000 responses between 1000 and 1990 ns with ten outliers at 50 us. The 99th
+    // percentile stays below 2.2 us, the 99.95th percentile sees the outliers. Percentiles are bucket bounds,
+    // at most 6.25% above the exact value.
+    uint32_t idx;
+
+    myunit_histogram_reset(&irq_latency);
+    myunit_histogram_reset(&irq_latency_core1);
+    for (idx = 0; idx < 10000; idx++) {
+        myunit_histogram_record((idx & 1) ? &irq_latency_core1 : &irq_latency, 1000 + (idx % 100) * 10);
+    }
+    for (idx = 0; idx < 10; idx++) {
+        MYUNIT_HISTOGRAM_RECORD(irq_latency_core1, 50000);
+    }
+    myunit_histogram_merge(&irq_latency, &irq_latency_core1);
+
+    MYUNIT_ASSERT_EQUAL(irq_latency.count, 10010);
+    MYUNIT_ASSERT_INRANGE(myunit_histogram_percentile(&irq_latency, 50.0), 1490, 1490 + 1490 / 16);
+    MYUNIT_ASSERT_PERCENTILE_BELOW(irq_latency, 99.0, 2200);
+    MYUNIT_ASSERT_TRUE(myunit_histogram_percentile(&irq_latency, 99.95) == 50000);
+    MYUNIT_HISTOGRAM_REPORT(irq_latency);
+}
+
+MYUNIT_TESTCASE(test_serial_link) {
+
+    // Test case description: 10000 baud sends a byte in 1 ms. A burst of 20 bytes into an empty 16 byte FIFO
+    // stalls until 4 bytes are sent, a byte written while the FIFO is still full stalls for 4 ms more. After the
+    // link went idle a full FIFO is accepted without stall and only the next byte stalls.
+    myunit_serial_t serial;
+
+    myunit_serial_init(&serial, 10000, 16, false);
+    MYUNIT_ASSERT_EQUAL(serial.byte_time, 1000000);
+    MYUNIT_ASSERT_EQUAL(myunit_serial_send(&serial, 0, 20), 4000000);
+    MYUNIT_ASSERT_EQUAL(myunit_serial_send(&serial, 1000000, 1), 4000000);
+    MYUNIT_ASSERT_EQUAL(myunit_serial_send(&serial, 100000000, 16), 0);
+    MYUNIT_ASSERT_EQUAL(myunit_serial_send(&serial, 100000000, 1), 1000000);
+    MYUNIT_ASSERT_EQUAL(serial.bytes, 38);
+    MYUNIT_ASSERT_EQUAL(serial.stalled, 9000000);
+
+    myunit_serial_init(&serial, 0, 16, false);
+    MYUNIT_ASSERT_EQUAL(serial.baud, 0);
+}
+
+// Lookup table built once by the test suite and restored from its snapshot before every test case.
+static uint16_t squares[256];
+static uint16_t squares_backup[256];
+static bool fixture_ready = false;
+
+static void squares_build(void)
+{
+    int idx;
+
+    for (idx = 0; idx < 256; idx++) {
+        squares[idx] = (uint16_t)(idx * idx);
+    }
+}
+
+static void fixture_setup(void)
+{
+    fixture_ready = true;
+}
+
+static void fixture_teardown(void)
+{
+    fixture_ready = false;
+}
+
+MYUNIT_TESTCASE(test_fixture_modify) {
+
+    // Test case description: Modifies the lookup table, the snapshot restores it for the next test case.
+    MYUNIT_ASSERT_TRUE(fixture_ready);
+    squares[16] = 0;
+    MYUNIT_ASSERT_EQUAL(squares[16], 0);
+}
+
+MYUNIT_TESTCASE(test_fixture_restored) {
+
+    // Test case description: Sees the lookup table as built by the test suite.
+    MYUNIT_ASSERT_TRUE(fixture_ready);
+    MYUNIT_ASSERT_EQUAL(squares[16], 256);
+}
+
+MYUNIT_TESTCASE(test_isolated_crash) {
+
+    // Test case description: Runs in an isolated copy of the test process. Its changes are discarded
+    // and the crash is reported as a failed test case instead of ending the test suite.
+    squares[16] = 0;
+    abort();
+}
+
+MYUNIT_TESTCASE(test_require) {
+
+    // Test case description: A failed MYUNIT_REQUIRE aborts the test case, so the dereference of the
+    // NULL pointer below is never reached.
+    uint8_t *buffer = NULL;
+
+    MYUNIT_REQUIRE_NOT_NULL(buffer);
+    MYUNIT_ASSERT_EQUAL(buffer[0], 0);
+}
+
+MYUNIT_TESTCASE(test_fail_fast) {
+
+    // Test case description: Skipped, the test suite is stopped by fail-fast after test_require failed.
+    MYUNIT_ASSERT_TRUE(true);
+}
+
 void myunit_testsuite_setup()
 {
 
@@ -357,5 +905,61 @@ MYUNIT_TESTSUITE(selftest)
 
     MYUNIT_EXEC_TESTCASE(test_sequence);
 
+    MYUNIT_EXEC_TESTCASE_TIMEOUT(test_timeout, 100);
+
+    MYUNIT_EXEC_TESTCASE(test_virtual_time);
+
+    MYUNIT_EXEC_TESTCASE(test_property_holds);
+    MYUNIT_EXEC_TESTCASE(test_property_fails);
+    MYUNIT_EXEC_TESTCASE(test_property_bytes);
+
+    MYUNIT_EXEC_FUZZ_TESTCASE(test_fuzz_tlv);
+
+    MYUNIT_EXEC_TESTCASE_P(test_parameterized);
+
+    MYUNIT_EXEC_TESTCASE(test_assert_aggregate);
+
+    MYUNIT_EXEC_TESTCASE(test_mock);
+
+    MYUNIT_SET_ASYNC_IDLE(peripherals_poll);
+    MYUNIT_START_ASYNC_TESTCASE(test_async_uart);
+    MYUNIT_START_ASYNC_TESTCASE(test_async_adc);
+    MYUNIT_RUN_ASYNC_TESTCASES();
+    MYUNIT_SET_ASYNC_IDLE(NULL);
+
+    MYUNIT_EXEC_TESTCASE(test_concurrent);
+
+    MYUNIT_EXEC_TESTCASE(test_guard_overflow);
+    MYUNIT_EXEC_TESTCASE(test_arena);
+    MYUNIT_EXEC_TESTCASE(test_arena_exhausted);
+    MYUNIT_EXEC_TESTCASE(test_baseline_statistics);
+    MYUNIT_EXEC_TESTCASE(test_format);
+    MYUNIT_EXEC_TESTCASE(test_cover);
+    MYUNIT_EXEC_TESTCASE(test_eventually);
+    MYUNIT_EXEC_TESTCASE(test_eventually_timeout);
+    MYUNIT_EXEC_TESTCASE(test_histogram);
+    MYUNIT_EXEC_TESTCASE(test_serial_link);
+
+    squares_build();
+    MYUNIT_SNAPSHOT_REGION(squares, squares_backup, sizeof(squares));
+    MYUNIT_SNAPSHOT_TAKE();
+    MYUNIT_SET_FIXTURE(fixture_setup, fixture_teardown);
+    MYUNIT_EXEC_TESTCASE(test_fixture_modify);
+    MYUNIT_EXEC_TESTCASE(test_fixture_restored);
+    MYUNIT_SET_ISOLATION(true);
+    MYUNIT_EXEC_TESTCASE(test_isolated_crash);
+    MYUNIT_SET_ISOLATION(false);
+    MYUNIT_SET_FIXTURE(NULL, NULL);
+    MYUNIT_SNAPSHOT_DROP();
+
+    MYUNIT_SET_REPEAT(50, 0, false);
+    MYUNIT_EXEC_TESTCASE(test_repeat);
+    MYUNIT_SET_REPEAT(1, 0, false);
+
+    // Stop at the next failed test case, keep these test cases last.
+    MYUNIT_SET_FAIL_FAST(1, 0);
+    MYUNIT_EXEC_TESTCASE(test_require);
+    MYUNIT_EXEC_TESTCASE(test_fail_fast);
+
     MYUNIT_TESTSUITE_END();
 }
@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_vclock.c                                            *
+ *  Description : Virtual clock for code under test                          *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+
+#include <stddef.h>
+#include "myunit_vclock.h"
+
+
+#ifndef MYUNIT_VCLOCK_TIMERS
+#define MYUNIT_VCLOCK_TIMERS 16 /*!< Number of timers which can be scheduled on the virtual clock at the same time. */
+#endif
+
+
+typedef struct {
+    uint64_t deadline;              /*!< Virtual time at which the timer expires */
+    uint32_t sequence;              /*!< Scheduling order, fires timers with equal deadlines in order */
+    void (*callback)(void *arg);    /*!< Function to call on expiry, NULL if the timer is unused */
+    void *arg;                      /*!< Argument passed to the callback */
+} myunit_vclock_timer_t;
+
+
+static bool myunit_vclock_active = false;
+static uint64_t myunit_vclock_time = 0;
+static uint32_t myunit_vclock_sequence = 0;
+static myunit_vclock_timer_t myunit_vclock_timers[MYUNIT_VCLOCK_TIMERS];
+
+
+uint64_t myunit_platform_now(void)
+{
+    return (myunit_vclock_active) ? myunit_vclock_time : myunit_platform_clock();
+}
+
+void myunit_vclock_enable(bool enable)
+{
+    int idx;
+
+    myunit_vclock_active = enable;
+    myunit_vclock_time = 0;
+    myunit_vclock_sequence = 0;
+
+    for (idx = 0; idx < MYUNIT_VCLOCK_TIMERS; idx++)
+    {
+        myunit_vclock_timers[idx].callback = NULL;
+    }
+}
+
+bool myunit_vclock_enabled(void)
+{
+    return myunit_vclock_active;
+}
+
+void myunit_vclock_advance(uint64_t ns)
+{
+    uint64_t target = myunit_vclock_time + ns;
+
+    for (;;)
+    {
+        myunit_vclock_timer_t *next = NULL;
+        void (*callback)(void *arg);
+        int idx;
+
+        for (idx = 0; idx < MYUNIT_VCLOCK_TIMERS; idx++)
+        {
+            myunit_vclock_timer_t *timer = &myunit_vclock_timers[idx];
+
+            if (!timer->callback || timer->deadline > target) continue;
+
+            if (!next || timer->deadline < next->deadline ||
+                (timer->deadline == next->deadline && (int32_t)(timer->sequence - next->sequence) < 0))
+            {
+                next = timer;
+            }
+        }
+
+        if (!next) break;
+
+        // Release the slot before the callback runs, it may reschedule itself.
+        myunit_vclock_time = next->deadline;
+        callback = next->callback;
+        next->callback = NULL;
+        callback(next->arg);
+    }
+
+    myunit_vclock_time = target;
+}
+
+int myunit_vclock_schedule(uint64_t delay, void (*callback)(void *arg), void *arg)
+{
+    int idx;
+
+    for (idx = 0; idx < MYUNIT_VCLOCK_TIMERS; idx++)
+    {
+        myunit_vclock_timer_t *timer = &myunit_vclock_timers[idx];
+
+        if (timer->callback) continue;
+
+        timer->deadline = myunit_vclock_time + delay;
+        timer->sequence = myunit_vclock_sequence++;
+        timer->callback = callback;
+        timer->arg = arg;
+        return idx;
+    }
+
+    return -1;
+}
+
+void myunit_vclock_cancel(int timer)
+{
+    if (timer >= 0 && timer < MYUNIT_VCLOCK_TIMERS)
+    {
+        myunit_vclock_timers[timer].callback = NULL;
+    }
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_vclock.h                                            *
+ *  Description : Virtual clock for code under test                          *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+#ifndef MYUNIT_VCLOCK_H_
+#define MYUNIT_VCLOCK_H_
+
+/*
+ * Unlike myunit.h, this header only contains declarations. It may be included
+ * by the code under test in any number of modules.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*!
+    \brief Reads the monotonic clock of the platform.
+
+    \details This function returns the time of a free running monotonic clock of
+             the platform. The origin is arbitrary, only differences are meaningful.
+             It is never affected by the virtual clock.
+
+    \return The current time in nanoseconds.
+*/
+extern uint64_t myunit_platform_clock(void);
+
+/*!
+    \brief Returns the current time for the code under test.
+
+    \details The code under test should read time through this function instead of
+             accessing a hardware timer or the operating system. While the virtual clock
+             is enabled, it returns the virtual time, which only advances when the test
+             calls `myunit_vclock_advance`. Otherwise it returns `myunit_platform_clock()`.
+
+    \return The current time in nanoseconds.
+*/
+extern uint64_t myunit_platform_now(void);
+
+/*!
+    \brief Enables or disables the virtual clock.
+
+    \details Enabling the virtual clock resets the virtual time to zero and cancels
+             all scheduled timers, so every test starts from the same state.
+
+    \param[in] enable `true` to enable the virtual clock, `false` to return to the platform clock.
+*/
+extern void myunit_vclock_enable(bool enable);
+
+/*!
+    \brief Checks whether the virtual clock is enabled.
+
+    \return `true` if `myunit_platform_now` returns virtual time.
+*/
+extern bool myunit_vclock_enabled(void);
+
+/*!
+    \brief Advances the virtual time.
+
+    \details Timers falling into the advanced interval are fired in the order of their
+             deadlines, with the virtual time set to the deadline of the timer while its
+             callback runs. Callbacks may schedule further timers, which are fired in the
+             same call if they fall into the interval as well.
+
+    \param[in] ns Number of nanoseconds to advance.
+*/
+extern void myunit_vclock_advance(uint64_t ns);
+
+/*!
+    \brief Schedules a one-shot timer on the virtual clock.
+
+    \param[in] delay    Delay in nanoseconds from the current virtual time.
+    \param[in] callback Function to call when the timer expires.
+    \param[in] arg      Argument passed to `callback`.
+
+    \return A timer handle for `myunit_vclock_cancel`, or a negative value if all
+            `MYUNIT_VCLOCK_TIMERS` timers are in use.
+*/
+extern int myunit_vclock_schedule(uint64_t delay, void (*callback)(void *arg), void *arg);
+
+/*!
+    \brief Cancels a scheduled timer.
+
+    \param[in] timer Handle returned by `myunit_vclock_schedule`.
+*/
+extern void myunit_vclock_cancel(int timer);
+
+#endif /* MYUNIT_VCLOCK_H_ */
@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_vclock_interpose.c                                  *
+ *  Description : Redirects libc time functions to the virtual clock         *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+
+/*
+ * Link this module with
+ *
+ *     -Wl,--wrap=clock_gettime -Wl,--wrap=nanosleep -Wl,--wrap=usleep
+ *
+ * (the myunit_vclock_interpose library in CMakeLists.txt does this) to let
+ * code under test which uses the POSIX time API run on the virtual clock.
+ * While the virtual clock is disabled, all calls are passed through.
+ *
+ * CLOCK_MONOTONIC_RAW is never virtualized, the platform clock relies on it.
+ */
+
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include "myunit_vclock.h"
+
+
+extern int __real_clock_gettime(clockid_t clockid, struct timespec *tp);
+extern int __real_nanosleep(const struct timespec *req, struct timespec *rem);
+extern int __real_usleep(useconds_t usec);
+
+
+static struct timespec myunit_vclock_realtime_origin;
+
+
+static void myunit_vclock_to_timespec(uint64_t ns, struct timespec *tp)
+{
+    tp->tv_sec = (time_t)(ns / 1000000000ULL);
+    tp->tv_nsec = (long)(ns % 1000000000ULL);
+}
+
+int __wrap_clock_gettime(clockid_t clockid, struct timespec *tp)
+{
+    if (!myunit_vclock_enabled() || clockid == CLOCK_MONOTONIC_RAW)
+    {
+        return __real_clock_gettime(clockid, tp);
+    }
+
+    if (clockid == CLOCK_REALTIME)
+    {
+        // Wall clock time starts at the real time of the first virtualized read.
+        uint64_t origin;
+
+        if (myunit_vclock_realtime_origin.tv_sec == 0)
+        {
+            __real_clock_gettime(CLOCK_REALTIME, &myunit_vclock_realtime_origin);
+        }
+
+        origin = (uint64_t)myunit_vclock_realtime_origin.tv_sec * 1000000000ULL + (uint64_t)myunit_vclock_realtime_origin.tv_nsec;
+        myunit_vclock_to_timespec(origin + myunit_platform_now(), tp);
+        return 0;
+    }
+
+    if (clockid == CLOCK_MONOTONIC || clockid == CLOCK_BOOTTIME)
+    {
+        myunit_vclock_to_timespec(myunit_platform_now(), tp);
+        return 0;
+    }
+
+    return __real_clock_gettime(clockid, tp);
+}
+
+int __wrap_nanosleep(const struct timespec *req, struct timespec *rem)
+{
+    if (!myunit_vclock_enabled())
+    {
+        return __real_nanosleep(req, rem);
+    }
+
+    if (req->tv_sec < 0 || req->tv_nsec < 0 || req->tv_nsec >= 1000000000L)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Sleeping code under test advances the virtual time instead of blocking.
+    myunit_vclock_advance((uint64_t)req->tv_sec * 1000000000ULL + (uint64_t)req->tv_nsec);
+
+    if (rem)
+    {
+        rem->tv_sec = 0;
+        rem->tv_nsec = 0;
+    }
+
+    return 0;
+}
+
+int __wrap_usleep(useconds_t usec)
+{
+    if (!myunit_vclock_enabled())
+    {
+        return __real_usleep(usec);
+    }
+
+    myunit_vclock_advance((uint64_t)usec * 1000ULL);
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*****************************************************************************
+ *                                                                           *
+ *  MyUnit – A lightweight unit testing framework for embedded C projects    *
+ *                                                                           *
+ *  Forked from uCUnit (C) 2007–2008 Sven Stefan Krauss                      *
+ *                  https://www.ucunit.org                                   *
+ *                                                                           *
+ *  (C) 2025 Marco Bacchi                                                    *
+ *      marco@bacchi.at                                                      *
+ *                                                                           *
+ *  File        : myunit_vclock_selftest.c                                   *
+ *  Description : Self test of the virtual clock interposer                  *
+ *  Author      : Marco Bacchi                                               *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+ * This file is part of MyUnit, a fork of uCUnit.
+ *
+ * It is licensed under the Common Public License Version 1.0 (CPL-1.0),
+ * as published by IBM Corporation and approved by the Open Source Initiative.
+ *
+ * MyUnit incorporates substantial modifications and extensions to the original
+ * uCUnit codebase. The original work is:
+ *   (C) 2007–2008 Sven Stefan Krauss, https://www.ucunit.org
+ *
+ * This file is distributed under the CPL in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the CPL for details.
+ *
+ * A copy of the license should have been provided with this distribution,
+ * or can be found online at:
+ *     http://www.opensource.org/licenses/cpl1.0.txt
+ */
+
+/*
+ * Links against myunit_vclock_interpose, the code under test below calls the
+ * POSIX time API and must run on the virtual clock.
+ */
+
+#include <time.h>
+#include <unistd.h>
+#include "myunit.h"
+
+
+// Code under test: polls a device with exponential backoff until it is ready.
+static int device_ready_after_ms;
+
+static int device_wait_ready(int max_polls)
+{
+    struct timespec start;
+    struct timespec now;
+    long backoff_ms = 1;
+    int polls;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (polls = 1; polls <= max_polls; polls++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec - start.tv_sec) * 1000L + (now.tv_nsec - start.tv_nsec) / 1000000L >= device_ready_after_ms)
+        {
+            return polls;
+        }
+
+        struct timespec delay = { backoff_ms / 1000, (backoff_ms % 1000) * 1000000L };
+        nanosleep(&delay, NULL);
+        backoff_ms *= 2;
+    }
+
+    return -1;
+}
+
+
+void myunit_testsuite_setup()
+{
+
+}
+
+void myunit_testsuite_teardown()
+{
+
+}
+
+MYUNIT_TESTCASE(test_nanosleep_advances_virtual_time) {
+
+    struct timespec delay = { 2, 500000000L };
+
+    MYUNIT_VIRTUAL_TIME_BEGIN();
+
+    // A 2.5 s sleep of the code under test returns at once and moves the virtual time.
+    MYUNIT_ASSERT_EQUAL(nanosleep(&delay, NULL), 0);
+    MYUNIT_ASSERT_TRUE(myunit_platform_now() == 2500000000ULL);
+
+    MYUNIT_ASSERT_EQUAL(usleep(1000), 0);
+    MYUNIT_ASSERT_TRUE(myunit_platform_now() == 2501000000ULL);
+
+    MYUNIT_VIRTUAL_TIME_END();
+}
+
+MYUNIT_TESTCASE(test_clock_gettime_reads_virtual_time) {
+
+    struct timespec now;
+
+    MYUNIT_VIRTUAL_TIME_BEGIN();
+
+    MYUNIT_ADVANCE_TIME(3000000123ULL);
+    MYUNIT_ASSERT_EQUAL(clock_gettime(CLOCK_MONOTONIC, &now), 0);
+    MYUNIT_ASSERT_EQUAL(now.tv_sec, 3);
+    MYUNIT_ASSERT_EQUAL(now.tv_nsec, 123);
+
+    MYUNIT_VIRTUAL_TIME_END();
+}
+
+MYUNIT_TESTCASE(test_backoff_on_virtual_time) {
+
+    uint64_t start;
+
+    // The device becomes ready after one minute, the backoff sleeps 1+2+...+32768 ms.
+    device_ready_after_ms = 60000;
+
+    start = myunit_platform_clock();
+    MYUNIT_VIRTUAL_TIME_BEGIN();
+
+    MYUNIT_ASSERT_EQUAL(device_wait_ready(32), 17);
+    MYUNIT_ASSERT_TRUE(myunit_platform_now() == 65535000000ULL);
+
+    MYUNIT_VIRTUAL_TIME_END();
+
+    // No real time was spent sleeping.
+    MYUNIT_ASSERT_TRUE(myunit_platform_clock() - start < 1000000000ULL);
+}
+
+MYUNIT_TESTCASE(test_nanosleep_passes_through) {
+
+    struct timespec delay = { 0, 2000000L };
+    uint64_t start = myunit_platform_clock();
+
+    // With the virtual clock disabled the code under test sleeps for real.
+    MYUNIT_ASSERT_FALSE(myunit_vclock_enabled());
+    MYUNIT_ASSERT_EQUAL(nanosleep(&delay, NULL), 0);
+    MYUNIT_ASSERT_TRUE(myunit_platform_clock() - start >= 2000000ULL);
+}
+
+MYUNIT_TESTSUITE(vclock_selftest)
+{
+    MYUNIT_TESTSUITE_BEGIN();
+
+    MYUNIT_EXEC_TESTCASE(test_nanosleep_advances_virtual_time);
+    MYUNIT_EXEC_TESTCASE(test_clock_gettime_reads_virtual_time);
+    MYUNIT_EXEC_TESTCASE(test_backoff_on_virtual_time);
+    MYUNIT_EXEC_TESTCASE(test_nanosleep_passes_through);
+
+    MYUNIT_TESTSUITE_END();
+}